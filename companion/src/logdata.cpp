@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "logdata.h"
+
+#include <QVarLengthArray>
+#include <math.h>
+#include <string.h>
+
+// progress is reported and cancellation checked every that many lines
+#define LOG_PROGRESS_LINES  4096
+
+static inline bool isBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+// Returns the next line of [pos, end) without its surrounding blanks and
+// moves pos to the start of the following line
+static void nextLine(const char *& pos, const char * end, const char *& lineBegin, const char *& lineEnd)
+{
+  const char * eol = (const char *)memchr(pos, '\n', end - pos);
+  lineBegin = pos;
+  lineEnd = eol ? eol : end;
+  pos = eol ? eol + 1 : end;
+
+  while (lineBegin < lineEnd && isBlank(*lineBegin))
+    lineBegin++;
+  while (lineEnd > lineBegin && isBlank(lineEnd[-1]))
+    lineEnd--;
+}
+
+static int parseNumber(const char * str, int length)
+{
+  int result = 0;
+  for (int i = 0; i < length; i++) {
+    if (!isDigit(str[i]))
+      return -1;
+    result = result * 10 + str[i] - '0';
+  }
+  return result;
+}
+
+// Locale independent decimal number parser. As QString::toDouble() did before,
+// anything which is not entirely a number (GPS coordinates, hex values, text)
+// gives 0
+static double parseValue(const char * str, int length)
+{
+  static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+
+  const char * end = str + length;
+  bool negative = false;
+
+  if (str < end && (*str == '-' || *str == '+'))
+    negative = (*str++ == '-');
+
+  quint64 mantissa = 0;
+  int digits = 0;
+  int scale = 0;
+  bool fraction = false;
+  bool hasDigits = false;
+
+  for (; str < end; str++) {
+    if (isDigit(*str)) {
+      hasDigits = true;
+      if (digits < 18) {
+        mantissa = mantissa * 10 + *str - '0';
+        if (mantissa)
+          digits++;
+        if (fraction)
+          scale--;
+      }
+      else if (!fraction) {
+        scale++;
+      }
+    }
+    else if (*str == '.' && !fraction) {
+      fraction = true;
+    }
+    else {
+      break;
+    }
+  }
+
+  if (str < end && (*str == 'e' || *str == 'E')) {
+    bool negativeExponent = false;
+    if (++str < end && (*str == '-' || *str == '+'))
+      negativeExponent = (*str++ == '-');
+    int exponent = 0;
+    if (str == end)
+      return 0;
+    for (; str < end && isDigit(*str); str++)
+      exponent = qMin(exponent * 10 + *str - '0', 1000);
+    scale += negativeExponent ? -exponent : exponent;
+  }
+
+  if (str != end || !hasDigits)
+    return 0;
+
+  const int maxPower = sizeof(powers) / sizeof(powers[0]) - 1;
+  double result = mantissa;
+  if (scale < 0)
+    result = -scale <= maxPower ? result / powers[-scale] : result * pow(10, scale);
+  else if (scale > 0)
+    result = scale <= maxPower ? result * powers[scale] : result * pow(10, scale);
+
+  return negative ? -result : result;
+}
+
+// Finds column in a record, returns false if the record is too short
+static bool findField(const char * line, int length, int column, const char *& field, int & fieldLength)
+{
+  const char * end = line + length;
+  for (int i = 0; i < column; i++) {
+    const char * comma = (const char *)memchr(line, ',', end - line);
+    if (!comma)
+      return false;
+    line = comma + 1;
+  }
+  const char * comma = (const char *)memchr(line, ',', end - line);
+  field = line;
+  fieldLength = (comma ? comma : end) - line;
+  return true;
+}
+
+QString LogData::field(int row, int column) const
+{
+  const char * value;
+  int length;
+  if (findField(data + rows.at(row).offset, rows.at(row).length, column, value, length))
+    return QString::fromUtf8(value, length);
+  return QString();
+}
+
+QStringList LogData::rowFields(int row) const
+{
+  return QString::fromUtf8(data + rows.at(row).offset, rows.at(row).length).split(',');
+}
+
+QByteArray LogData::rawHeader() const
+{
+  return QByteArray(data + headerRow.offset, headerRow.length);
+}
+
+QByteArray LogData::rawRow(int row) const
+{
+  return QByteArray(data + rows.at(row).offset, rows.at(row).length);
+}
+
+QDateTime LogData::timeStamp(int row) const
+{
+  return QDateTime::fromMSecsSinceEpoch(qRound64(timeStamps.at(row) * 1000));
+}
+
+LogLoader::LogLoader(LogData * logData, const QString & fileName) :
+  logData(logData),
+  fileName(fileName),
+  stopRequested(false),
+  lastHourStart(0)
+{
+  memset(lastHour, 0, sizeof(lastHour));
+}
+
+void LogLoader::run()
+{
+  emit finished(load());
+}
+
+void LogLoader::stop()
+{
+  stopRequested = true;
+}
+
+// Timestamps are local time, "yyyy-MM-dd" and "HH:mm:ss[.zzz]". The local time
+// at the start of each hour is only computed once.
+bool LogLoader::parseTimeStamp(const char * date, int dateLength, const char * time, int timeLength, double & result)
+{
+  if (dateLength != 10 || date[4] != '-' || date[7] != '-')
+    return false;
+  if (timeLength < 8 || time[2] != ':' || time[5] != ':' || (timeLength > 8 && time[8] != '.'))
+    return false;
+
+  int minutes = parseNumber(time + 3, 2);
+  int seconds = parseNumber(time + 6, 2);
+  if (minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59)
+    return false;
+
+  double fraction = 0;
+  if (timeLength > 9) {
+    int value = parseNumber(time + 9, qMin(timeLength - 9, 6));
+    if (value < 0)
+      return false;
+    fraction = value / pow(10, qMin(timeLength - 9, 6));
+  }
+
+  if (memcmp(lastHour, date, 10) || memcmp(lastHour + 10, time, 2)) {
+    QDate day(parseNumber(date, 4), parseNumber(date + 5, 2), parseNumber(date + 8, 2));
+    int hour = parseNumber(time, 2);
+    if (!day.isValid() || hour < 0 || hour > 23)
+      return false;
+    lastHourStart = QDateTime(day, QTime(hour, 0)).toMSecsSinceEpoch() / 1000.0;
+    memcpy(lastHour, date, 10);
+    memcpy(lastHour + 10, time, 2);
+  }
+
+  result = lastHourStart + minutes * 60 + seconds + fraction;
+  return true;
+}
+
+int LogLoader::load()
+{
+  QFile & file = logData->file;
+  file.setFileName(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return LOAD_OPEN_ERROR;
+  }
+
+  qint64 size = file.size();
+  const char * data = size > 0 ? (const char *)file.map(0, size) : nullptr;
+  if (!data) {
+    logData->buffer = file.readAll();
+    size = logData->buffer.size();
+    data = logData->buffer.constData();
+  }
+  logData->data = data;
+
+  const char * pos = data;
+  const char * end = data + size;
+  const char * line;
+  const char * lineEnd;
+
+  nextLine(pos, end, line, lineEnd);
+  if (lineEnd - line < 9 || memcmp(line, "Date,Time", 9)) {
+    return LOAD_FORMAT_ERROR;
+  }
+
+  logData->headerRow = { line - data, int(lineEnd - line) };
+  logData->headerFields = QString::fromUtf8(line, lineEnd - line).split(',');
+  const int numFields = logData->headerFields.size();
+  logData->columns.resize(numFields - 2);
+
+  // the header is usually about as long as a record
+  int estimate = size / qMax<qint64>(lineEnd - line, 16);
+  logData->rows.reserve(estimate);
+  logData->timeStamps.reserve(estimate);
+
+  QVarLengthArray<double, 64> values;
+  int lines = 0;
+  int lastPercent = -1;
+
+  while (pos < end) {
+    if (++lines % LOG_PROGRESS_LINES == 0) {
+      if (stopRequested) {
+        return LOAD_CANCELLED;
+      }
+      int percent = (pos - data) * 100 / size;
+      if (percent != lastPercent) {
+        lastPercent = percent;
+        emit progress(percent);
+      }
+    }
+
+    nextLine(pos, end, line, lineEnd);
+
+    const char * fields[2] = { line, line };
+    int lengths[2] = { 0, 0 };
+    int count = 0;
+    values.clear();
+
+    for (const char * field = line; field <= lineEnd; count++) {
+      const char * comma = (const char *)memchr(field, ',', lineEnd - field);
+      const char * fieldEnd = comma ? comma : lineEnd;
+      if (count < 2) {
+        fields[count] = field;
+        lengths[count] = fieldEnd - field;
+      }
+      else if (count < numFields) {
+        values.append(parseValue(field, fieldEnd - field));
+      }
+      field = fieldEnd + 1;
+    }
+
+    double time;
+    if (count != numFields || !parseTimeStamp(fields[0], lengths[0], fields[1], lengths[1], time)) {
+      logData->errors++;
+      continue;
+    }
+
+    if (logData->rows.isEmpty() || int(time - logData->timeStamps.last()) > LOG_SESSION_GAP) {
+      logData->sessionStarts.append(logData->rows.size());
+    }
+
+    logData->rows.append({ line - data, int(lineEnd - line) });
+    logData->timeStamps.append(time);
+    for (int i = 0; i < values.size(); i++) {
+      logData->columns[i].append(values[i]);
+    }
+  }
+
+  emit progress(100);
+
+  return logData->rows.isEmpty() ? LOAD_NO_DATA : LOAD_OK;
+}
+
+LogTableModel::LogTableModel(QObject * parent) :
+  QAbstractTableModel(parent),
+  logData(nullptr)
+{
+}
+
+void LogTableModel::setLogData(const LogData * logData)
+{
+  beginResetModel();
+  this->logData = logData;
+  endResetModel();
+}
+
+int LogTableModel::rowCount(const QModelIndex & parent) const
+{
+  return (logData && !parent.isValid()) ? logData->rowCount() : 0;
+}
+
+int LogTableModel::columnCount(const QModelIndex & parent) const
+{
+  return (logData && !parent.isValid()) ? logData->columnCount() : 0;
+}
+
+QVariant LogTableModel::data(const QModelIndex & index, int role) const
+{
+  if (!logData || !index.isValid() || role != Qt::DisplayRole)
+    return QVariant();
+
+  return logData->field(index.row(), index.column());
+}
+
+QVariant LogTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (!logData || role != Qt::DisplayRole)
+    return QVariant();
+
+  if (orientation == Qt::Horizontal)
+    return logData->header().value(section);
+
+  return section + 1;
+}
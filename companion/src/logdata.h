@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _LOGDATA_H_
+#define _LOGDATA_H_
+
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+// a new flight session starts when two records are more than this apart (seconds)
+#define LOG_SESSION_GAP    60
+
+// Telemetry log (CSV) loaded column by column.
+// The file is kept memory mapped: the numbers are parsed once into one array
+// per column, the text of a record is only extracted when it is displayed
+// or exported.
+class LogData
+{
+  friend class LogLoader;
+
+  public:
+    LogData() = default;
+
+    bool isEmpty() const { return rows.isEmpty(); }
+    int rowCount() const { return rows.size(); }
+    int columnCount() const { return headerFields.size(); }
+    int errorCount() const { return errors; }
+    const QStringList & header() const { return headerFields; }
+    QString fileName() const { return file.fileName(); }
+
+    QString field(int row, int column) const;
+    QStringList rowFields(int row) const;
+    QByteArray rawHeader() const;
+    QByteArray rawRow(int row) const;
+
+    // record timestamps, in seconds since epoch
+    const QVector<double> & times() const { return timeStamps; }
+    QDateTime timeStamp(int row) const;
+
+    // values of column (Date and Time excluded), 0 when not a number
+    const QVector<double> & values(int column) const { return columns.at(column - 2); }
+
+    // first row of each flight session
+    const QVector<int> & sessions() const { return sessionStarts; }
+
+  protected:
+    struct Row {
+      qint64 offset;
+      int length;
+    };
+
+    QFile file;
+    QByteArray buffer;          // only used when the file cannot be mapped
+    const char * data = nullptr;
+    Row headerRow = { 0, 0 };
+    QStringList headerFields;
+    QVector<Row> rows;
+    QVector<double> timeStamps;
+    QVector<QVector<double>> columns;
+    QVector<int> sessionStarts;
+    int errors = 0;
+};
+
+class LogLoader : public QObject
+{
+  Q_OBJECT
+
+  public:
+    enum Result {
+      LOAD_OK,
+      LOAD_CANCELLED,
+      LOAD_OPEN_ERROR,
+      LOAD_FORMAT_ERROR,
+      LOAD_NO_DATA
+    };
+
+    LogLoader(LogData * logData, const QString & fileName);
+
+  public slots:
+    void run();
+    void stop();
+
+  signals:
+    void progress(int percent);
+    void finished(int result);
+
+  protected:
+    int load();
+    bool parseTimeStamp(const char * date, int dateLength, const char * time, int timeLength, double & result);
+
+    LogData * logData;
+    QString fileName;
+    std::atomic<bool> stopRequested;
+    char lastHour[12];          // yyyy-MM-ddHH of the last timestamp
+    double lastHourStart;
+};
+
+// Read only view of a LogData for the records table
+class LogTableModel : public QAbstractTableModel
+{
+  Q_OBJECT
+
+  public:
+    explicit LogTableModel(QObject * parent = nullptr);
+
+    void setLogData(const LogData * logData);
+
+    int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+  protected:
+    const LogData * logData;
+};
+
+#endif // _LOGDATA_H_
@@ -23,6 +23,7 @@
 #include "appdata.h"
 #include "ui_logsdialog.h"
 #include "helpers.h"
+#include <QProgressDialog>
 #if defined _MSC_VER || !defined __GNUC__
 #include <windows.h>
 #else
@@ -32,16 +33,22 @@
 LogsDialog::LogsDialog(QWidget *parent) :
   QDialog(parent, Qt::WindowTitleHint | Qt::WindowSystemMenuHint),
   ui(new Ui::LogsDialog),
+  logData(nullptr),
+  loadingData(nullptr),
+  logLoader(nullptr),
+  loadThread(nullptr),
+  loadProgress(nullptr),
   tracerMaxAlt(0),
   cursorA(0),
   cursorB(0),
   cursorLine(0)
 {
-  csvlog.clear();
-
   ui->setupUi(this);
   setWindowIcon(CompanionIcon("logs.png"));
 
+  logModel = new LogTableModel(this);
+  ui->logTable->setModel(logModel);
+
   plotLock=false;
 
   colors.append(Qt::green);
@@ -110,19 +117,26 @@ LogsDialog::LogsDialog(QWidget *parent) :
 
   // make left axes transfer its range to right axes:
   connect(axisRect->axis(QCPAxis::atLeft), SIGNAL(rangeChanged(QCPRange)), this, SLOT(yAxisChangeRanges(QCPRange)));
+  // only give the visible points to the graphs when zooming and dragging:
+  connect(axisRect->axis(QCPAxis::atBottom), SIGNAL(rangeChanged(QCPRange)), this, SLOT(xAxisChangeRange(QCPRange)));
 
   // connect some interaction slots:
   connect(ui->customPlot, SIGNAL(titleDoubleClick(QMouseEvent*, QCPPlotTitle*)), this, SLOT(titleDoubleClick(QMouseEvent*, QCPPlotTitle*)));
   connect(ui->customPlot, SIGNAL(axisDoubleClick(QCPAxis*,QCPAxis::SelectablePart,QMouseEvent*)), this, SLOT(axisLabelDoubleClick(QCPAxis*,QCPAxis::SelectablePart)));
   connect(ui->customPlot, SIGNAL(legendDoubleClick(QCPLegend*,QCPAbstractLegendItem*,QMouseEvent*)), this, SLOT(legendDoubleClick(QCPLegend*,QCPAbstractLegendItem*)));
   connect(ui->FieldsTW, SIGNAL(itemSelectionChanged()), this, SLOT(plotLogs()));
-  connect(ui->logTable, SIGNAL(itemSelectionChanged()), this, SLOT(plotLogs()));
+  connect(ui->logTable->selectionModel(), SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this, SLOT(plotLogs()));
   connect(ui->Reset_PB, SIGNAL(clicked()), this, SLOT(plotLogs()));
   connect(ui->SaveSession_PB, SIGNAL(clicked()), this, SLOT(saveSession()));
 }
 
 LogsDialog::~LogsDialog()
 {
+  if (logLoader) {
+    logLoader->stop();
+    finishLoading();
+  }
+  delete logData;
   delete ui;
 }
 
@@ -236,84 +250,76 @@ void LogsDialog::selectionChanged()
   }
 }
 
-QList<QStringList> LogsDialog::filterGePoints(const QList<QStringList> & input)
+bool LogsDialog::filterGePoints(QVector<int> & rows)
 {
-  QList<QStringList> result;
-
-  int n = input.count();
-  if (n == 0) {
-    return result;
+  if (!logData) {
+    return false;
   }
 
-  int gpscol = 0;
-  for (int i=1; i<input.at(0).count(); i++) {
-    if (input.at(0).at(i) == "GPS") {
-      gpscol=i;
-    }
-  }
-  if (gpscol == 0) {
+  int gpscol = logData->header().lastIndexOf("GPS");
+  if (gpscol <= 0) {
     QMessageBox::critical(this, tr("Error: no GPS data found"),
       tr("The column containing GPS coordinates must be named \"GPS\".\n\n\
 The columns for altitude \"GAlt\" and for speed \"GSpd\" are optional"));
-    return result;
+    return false;
   }
 
-  result.append(input.at(0));
-  bool rangeSelected = ui->logTable->selectionModel()->selectedRows().length() > 0;
+  QItemSelectionModel * selection = ui->logTable->selectionModel();
+  bool rangeSelected = selection->hasSelection();
 
   GpsGlitchFilter glitchFilter;
   GpsLatLonFilter latLonFilter;
 
-  for (int i = 1; i < n; i++) {
-    if ((ui->logTable->item(i-1, 1)->isSelected() && rangeSelected) || !rangeSelected) {
+  for (int row = 0; row < logData->rowCount(); row++) {
+    if ((rangeSelected && selection->isSelected(logModel->index(row, 1))) || !rangeSelected) {
 
-      GpsCoord coord = extractGpsCoordinates(input.at(i).at(gpscol));
+      GpsCoord coord = extractGpsCoordinates(logData->field(row, gpscol));
 
       // glitch filter
       if ( glitchFilter.isGlitch(coord) ) {
-        // qDebug() << "filterGePoints(): GPS glitch detected at" << i << coord.latitude << coord.longitude;
+        // qDebug() << "filterGePoints(): GPS glitch detected at" << row << coord.latitude << coord.longitude;
         continue;
       }
 
       // lat long pair filter
       if ( !latLonFilter.isValid(coord) ) {
-        // qDebug() << "filterGePoints(): Lat-Lon pair wrong, skipping at" << i << coord.latitude << coord.longitude;
+        // qDebug() << "filterGePoints(): Lat-Lon pair wrong, skipping at" << row << coord.latitude << coord.longitude;
         continue;
       }
 
       // qDebug() << "point " << latitude << longitude;
-      result.append(input.at(i));
+      rows.append(row);
     }
   }
 
-  // qDebug() << "filterGePoints(): filtered from" << input.count() << "to " << result.count() << "points";
-  return result;
+  // qDebug() << "filterGePoints(): filtered from" << logData->rowCount() << "to " << rows.count() << "points";
+  return true;
 }
 
 void LogsDialog::exportToGoogleEarth()
 {
   // filter data points
-  QList<QStringList> dataPoints = filterGePoints(csvlog);
-  int n = dataPoints.count(); // number of points to export
-  if (n==0) return;
+  QVector<int> dataPoints;
+  if (!filterGePoints(dataPoints)) return;
 
+  const QStringList & header = logData->header();
   int gpscol=0, altcol=0, speedcol=0;
   double altMultiplier = 1.0;
 
   QSet<int> nondataCols;
-  for (int i=1; i<dataPoints.at(0).count(); i++) {
+  for (int i=1; i<header.count(); i++) {
     // Long,Lat,Course,GPS Speed,GPS Alt
-    if (dataPoints.at(0).at(i) == "GPS") {
+    if (header.at(i) == "GPS") {
       gpscol=i;
     }
-    if (dataPoints.at(0).at(i).contains("GAlt")) {
+    if (header.at(i).contains("GAlt")) {
       altcol = i;
       nondataCols << i;
-      if (dataPoints.at(0).at(i).contains("(ft)")) {
+      if (header.at(i).contains("(ft)")) {
         altMultiplier = 0.3048;    // feet to meters
       }
     }
-    if (dataPoints.at(0).at(i).contains("GSpd")) {
+    if (header.at(i).contains("GSpd")) {
       speedcol = i;
       nondataCols << i;
     }
@@ -353,9 +359,9 @@ void LogsDialog::exportToGoogleEarth()
   outputStream << "\t\t\t<gx:SimpleArrayField name=\"GPSSpeed\" type=\"float\">\n\t\t\t\t<displayName>GPS Speed</displayName>\n\t\t\t</gx:SimpleArrayField>\n";
 
   // declare additional fields
-  for (int i=0; i<dataPoints.at(0).count()-2; i++) {
+  for (int i=0; i<header.count()-2; i++) {
     if (ui->FieldsTW->item(i, 0) && ui->FieldsTW->item(i, 0)->isSelected() && !nondataCols.contains(i+2)) {
-      QString origName = dataPoints.at(0).at(i+2);
+      QString origName = header.at(i+2);
       QString safeName = origName;
       safeName.replace(" ","_");
       outputStream << "\t\t\t<gx:SimpleArrayField name=\""<< safeName <<"\" ";
@@ -378,17 +384,17 @@ void LogsDialog::exportToGoogleEarth()
   outputStream << "\n\t\t\t\t\t<altitudeMode>absolute</altitudeMode>\n";
 
   // time data points
-  for (int i=1; i<n; i++) {
-    QString tstamp=dataPoints.at(i).at(0)+QString("T")+dataPoints.at(i).at(1)+QString("Z");
+  for (int row : dataPoints) {
+    QString tstamp=logData->field(row, 0)+QString("T")+logData->field(row, 1)+QString("Z");
     outputStream << "\t\t\t\t\t<when>"<< tstamp <<"</when>\n";
   }
 
   // coordinate data points
   outputStream.setRealNumberNotation(QTextStream::FixedNotation);
   outputStream.setRealNumberPrecision(8);
-  for (int i=1; i<n; i++) {
-    GpsCoord coord = extractGpsCoordinates(dataPoints.at(i).at(gpscol));
-    int altitude = altcol ? (dataPoints.at(i).at(altcol).toFloat() * altMultiplier) : 0;
+  for (int row : dataPoints) {
+    GpsCoord coord = extractGpsCoordinates(logData->field(row, gpscol));
+    int altitude = altcol ? (logData->field(row, altcol).toFloat() * altMultiplier) : 0;
     outputStream << "\t\t\t\t\t<gx:coord>" << coord.longitude << " " << coord.latitude << " " << altitude << " </gx:coord>\n" ;
   }
 
@@ -398,20 +404,20 @@ void LogsDialog::exportToGoogleEarth()
   if (speedcol) {
     // gps speed data points
     outputStream << "\t\t\t\t\t\t\t<gx:SimpleArrayData name=\"GPSSpeed\">\n";
-    for (int i=1; i<n; i++) {
-      outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< dataPoints.at(i).at(speedcol) <<"</gx:value>\n";
+    for (int row : dataPoints) {
+      outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< logData->field(row, speedcol) <<"</gx:value>\n";
     }
     outputStream << "\t\t\t\t\t\t\t</gx:SimpleArrayData>\n";
   }
 
   // add values for additional fields
-  for (int i=0; i<dataPoints.at(0).count()-2; i++) {
+  for (int i=0; i<header.count()-2; i++) {
     if (ui->FieldsTW->item(i, 0) && ui->FieldsTW->item(i, 0)->isSelected() && !nondataCols.contains(i+2)) {
-      QString safeName = dataPoints.at(0).at(i+2);;
+      QString safeName = header.at(i+2);
       safeName.replace(" ","_");
       outputStream << "\t\t\t\t\t\t\t<gx:SimpleArrayData name=\""<< safeName <<"\">\n";
-      for (int j=1; j<n; j++) {
-        outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< dataPoints.at(j).at(i+2) <<"</gx:value>\n";
+      for (int row : dataPoints) {
+        outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< logData->field(row, i+2) <<"</gx:value>\n";
       }
       outputStream << "\t\t\t\t\t\t\t</gx:SimpleArrayData>\n";
     }
@@ -571,143 +577,117 @@ void LogsDialog::on_fileOpen_BT_clicked()
   if (!fileName.isEmpty()) {
     g.logDir(fileName);
     ui->FileName_LE->setText(fileName);
-    if (cvsFileParse()) {
-      ui->FieldsTW->clear();
-      ui->logTable->clear();
-      ui->FieldsTW->setShowGrid(false);
-      ui->FieldsTW->setContentsMargins(0,0,0,0);
-      ui->FieldsTW->setRowCount(csvlog.at(0).count()-2);
-      ui->FieldsTW->setColumnCount(1);
-      ui->FieldsTW->setHorizontalHeaderLabels(QStringList(tr("Available fields")));
-      ui->logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-      for (int i=2; i<csvlog.at(0).count(); i++) {
-        QTableWidgetItem* item= new QTableWidgetItem(csvlog.at(0).at(i));
-        ui->FieldsTW->setItem(i-2, 0, item);
-      }
-      ui->FieldsTW->resizeRowsToContents();
-      ui->logTable->setColumnCount(csvlog.at(0).count());
-      ui->logTable->setRowCount(csvlog.count()-1);
-      ui->logTable->setHorizontalHeaderLabels(csvlog.at(0));
-
-      QAbstractItemModel *model = ui->logTable->model();
-      for (int i=1; i<csvlog.count(); i++) {
-        for (int j=0; j<csvlog.at(0).count(); j++) {
-          model->setData(model->index(i - 1, j, QModelIndex()), csvlog.at(i).at(j));
-        }
-      }
-
-      ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-      QVarLengthArray<int> sizes;
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
-        sizes.append(ui->logTable->columnWidth(i));
-      }
-      ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
-        ui->logTable->setColumnWidth(i, sizes.at(i));
-      }
-    }
+    loadLogFile(fileName);
   }
 }
 
-void LogsDialog::saveSession()
+void LogsDialog::loadLogFile(const QString & fileName)
 {
-  int index = ui->sessions_CB->currentIndex();
-  // ignore index 0 is its all sessions combined
-  if(index > 0) {
-    int n = csvlog.count();
-    QList<QStringList> sessionCsvLog;
-    // add CSV headers from first row of source file
-    sessionCsvLog.push_back(csvlog[0]);
-    // find session breaks
-    int currentSession = 0;
-    QDateTime lastvalue;
-    for (int i = 1; i < n; i++) {
-      QDateTime tmp = getRecordTimeStamp(i);
-      if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-        currentSession++;
-      }
-      lastvalue = tmp;
-      if(currentSession == index) {
-        // add records to filtered list
-        sessionCsvLog.push_back(csvlog[i]);
-      }
-      else if (currentSession > index) {
-        break;
-      }
-    }
-    // save the filtered records to a new file
-    QString newFilename = logFilename;
-    newFilename.append(QString("-Session%1.csv").arg(index));
-    QString filename = QFileDialog::getSaveFileName(this, "Save log", newFilename, "CSV files (.csv);", 0, 0); // getting the filename (full path)
-    QFile data(filename);
-    if(data.open(QFile::WriteOnly |QFile::Truncate)) {
-      QTextStream output(&data);
-      int numRecords = sessionCsvLog.count();
-      for(int i = 0; i < numRecords; i++){
-        output << sessionCsvLog[i].join(",") << '\n';
-      }
-    }
-    sessionCsvLog.clear();
-  }
-}
+  ui->fileOpen_BT->setEnabled(false);
 
-bool LogsDialog::cvsFileParse()
-{
-  QFile file(ui->FileName_LE->text());
-  int errors=0;
-  int lines=-1;
+  // the file is parsed in a separate thread, we only use signals/slots from here on
+  loadingData = new LogData();
+  logLoader = new LogLoader(loadingData, fileName);
+  loadThread = new QThread(this);
+  logLoader->moveToThread(loadThread);
 
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
-    return false;
-  }
-  else {
-    csvlog.clear();
-    logFilename.clear();
-    QTextStream inputStream(&file);
-    QString buffer = file.readLine();
+  loadProgress = new QProgressDialog(tr("Loading %1").arg(QFileInfo(fileName).fileName()), tr("Cancel"), 0, 100, this);
+  loadProgress->setWindowModality(Qt::WindowModal);
+  loadProgress->setMinimumDuration(500);
+  loadProgress->setAutoReset(false);
 
-    if (buffer.startsWith("Date,Time")) {
-      file.reset();
-    }
-    else {
-      return false;
-    }
+  connect(loadThread,   &QThread::started,          logLoader,    &LogLoader::run);
+  connect(logLoader,    &LogLoader::progress,       loadProgress, &QProgressDialog::setValue);
+  connect(logLoader,    &LogLoader::finished,       this,         &LogsDialog::onLogLoaded);
+  connect(loadProgress, &QProgressDialog::canceled, logLoader,    &LogLoader::stop, Qt::DirectConnection);
 
-    int numfields=-1;
-    while (!file.atEnd()) {
-      QString line = file.readLine().trimmed();
-      QStringList columns = line.split(',');
-      if (numfields==-1) {
-        numfields=columns.count();
-      }
-      if (columns.count()==numfields) {
-        csvlog.append(columns);
-      }
-      else {
-        errors++;
-      }
-      lines++;
-    }
+  loadThread->start(QThread::LowPriority);
+}
+
+void LogsDialog::finishLoading()
+{
+  loadThread->quit();
+  loadThread->wait();
+  delete logLoader;
+  delete loadThread;
+  delete loadProgress;
+  delete loadingData;
+  logLoader = nullptr;
+  loadThread = nullptr;
+  loadProgress = nullptr;
+  loadingData = nullptr;
+  ui->fileOpen_BT->setEnabled(true);
+}
+
+void LogsDialog::onLogLoaded(int result)
+{
+  if (!logLoader) return;
 
-    logFilename = QFileInfo(file.fileName()).baseName();
+  LogData * data = nullptr;
+  if (result == LogLoader::LOAD_OK) {
+    data = loadingData;
+    loadingData = nullptr;
   }
+  finishLoading();
 
-  file.close();
-  if (errors > 1) {
-    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(errors).arg(lines));
+  if (!data) {
+    return;
   }
 
-  int n = csvlog.count();
-  if (n == 1) {
-    csvlog.clear();
-    return false;
+  if (data->errorCount() > 1) {
+    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(data->errorCount()).arg(data->errorCount() + data->rowCount()));
   }
 
   plotLock = true;
+
+  logModel->setLogData(data);
+  delete logData;
+  logData = data;
+  logFilename = QFileInfo(logData->fileName()).baseName();
+
   setFlightSessions();
+
+  ui->FieldsTW->clear();
+  ui->FieldsTW->setShowGrid(false);
+  ui->FieldsTW->setContentsMargins(0,0,0,0);
+  ui->FieldsTW->setRowCount(logData->columnCount()-2);
+  ui->FieldsTW->setColumnCount(1);
+  ui->FieldsTW->setHorizontalHeaderLabels(QStringList(tr("Available fields")));
+  for (int i=2; i<logData->columnCount(); i++) {
+    QTableWidgetItem* item= new QTableWidgetItem(logData->header().at(i));
+    ui->FieldsTW->setItem(i-2, 0, item);
+  }
+  ui->FieldsTW->resizeRowsToContents();
+
+  // only the visible rows are measured
+  ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+  ui->logTable->resizeColumnsToContents();
+
   plotLock = false;
+  plotLogs();
+}
 
-  return true;
+void LogsDialog::saveSession()
+{
+  int index = ui->sessions_CB->currentIndex();
+  // ignore index 0 is its all sessions combined
+  if(index > 0 && logData) {
+    const QVector<int> & sessions = logData->sessions();
+    int first = sessions.at(index - 1);
+    int last = index < sessions.size() ? sessions.at(index) : logData->rowCount();
+    // save the session records to a new file
+    QString newFilename = logFilename;
+    newFilename.append(QString("-Session%1.csv").arg(index));
+    QString filename = QFileDialog::getSaveFileName(this, "Save log", newFilename, "CSV files (.csv);", 0, 0); // getting the filename (full path)
+    QFile data(filename);
+    if(data.open(QFile::WriteOnly |QFile::Truncate)) {
+      // add CSV headers from first row of source file
+      data.write(logData->rawHeader() + '\n');
+      for(int i = first; i < last; i++){
+        data.write(logData->rawRow(i) + '\n');
+      }
+    }
+  }
 }
 
 struct FlightSession {
@@ -715,14 +695,6 @@ struct FlightSession {
   QDateTime end;
 };
 
-QDateTime LogsDialog::getRecordTimeStamp(int index)
-{
-  QString tstamp = csvlog.at(index).at(0) + " " + csvlog.at(index).at(1);
-  if (csvlog.at(index).at(1).contains("."))
-    return QDateTime::fromString(tstamp, "yyyy-MM-dd HH:mm:ss.zzz");
-  return QDateTime::fromString(tstamp, "yyyy-MM-dd HH:mm:ss");
-}
-
 QString LogsDialog::generateDuration(const QDateTime & start, const QDateTime & end)
 {
   int secs = start.secsTo(end);
@@ -740,38 +712,29 @@ void LogsDialog::setFlightSessions()
   ui->sessions_CB->clear();
   ui->SaveSession_PB->setEnabled(false);
 
-  int n = csvlog.count();
+  int n = logData->rowCount();
   // qDebug() << "records" << n;
 
-  // find session breaks
-  QList<int> sessions;
-  QDateTime lastvalue;
-  for (int i = 1; i < n; i++) {
-    QDateTime tmp = getRecordTimeStamp(i);
-    if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-      sessions.push_back(i-1);
-      // qDebug() << "session index" << i-1;
-    }
-    lastvalue = tmp;
-  }
-  sessions.push_back(n-1);
+  // session breaks are found while loading
+  const QVector<int> & sessions = logData->sessions();
 
   //now construct a list of sessions with their times
   //total time
-  int noSesions = sessions.size()-1;
+  int noSesions = sessions.size();
   QString label = QString("%1 ").arg(noSesions);
   label += tr(noSesions > 1 ? "sessions" : "session");
-  label += " <" + tr("time span") + generateDuration(getRecordTimeStamp(1), getRecordTimeStamp(n-1)) + ">";
+  label += " <" + tr("time span") + generateDuration(logData->timeStamp(0), logData->timeStamp(n-1)) + ">";
   ui->sessions_CB->addItem(label);
 
   // add individual sessions
-  if (sessions.size() > 2) {
-    for (int i = 1; i < sessions.size(); i++) {
-      QDateTime sessionStart = getRecordTimeStamp(sessions.at(i-1)+1);
-      QDateTime sessionEnd = getRecordTimeStamp(sessions.at(i));
+  if (sessions.size() > 1) {
+    for (int i = 0; i < sessions.size(); i++) {
+      int last = (i + 1 < sessions.size() ? sessions.at(i+1) : n) - 1;
+      QDateTime sessionStart = logData->timeStamp(sessions.at(i));
+      QDateTime sessionEnd = logData->timeStamp(last);
       QString label = sessionStart.toString("HH:mm:ss") + " <" + tr("duration ") + generateDuration(sessionStart, sessionEnd) + ">";
-      ui->sessions_CB->addItem(label, sessions.at(i-1));
-      // qDebug() << "added label" << label << sessions.at(i-1);
+      ui->sessions_CB->addItem(label, sessions.at(i));
+      // qDebug() << "added label" << label << sessions.at(i);
     }
   }
 }
@@ -788,13 +751,13 @@ void LogsDialog::on_sessions_CB_currentIndexChanged(int index)
     if (index < ui->sessions_CB->count() - 1) {
       bottom = ui->sessions_CB->itemData(index + 1, Qt::UserRole).toInt();
     } else {
-      bottom = ui->logTable->rowCount();
+      bottom = logModel->rowCount();
     }
 
     QModelIndex topLeft = ui->logTable->model()->index(
       ui->sessions_CB->itemData(index, Qt::UserRole).toInt(), 0 , QModelIndex());
     QModelIndex bottomRight = ui->logTable->model()->index(
-      bottom - 1, ui->logTable->columnCount() - 1, QModelIndex());
+      bottom - 1, logModel->columnCount() - 1, QModelIndex());
 
     QItemSelection selection(topLeft, bottomRight);
     ui->logTable->selectionModel()->select(selection, QItemSelectionModel::Select);
@@ -813,32 +776,42 @@ void LogsDialog::plotLogs()
 {
   if (plotLock) return;
 
-  if (!ui->FieldsTW->selectedItems().length()) {
+  if (!logData || !ui->FieldsTW->selectedItems().length()) {
     removeAllGraphs();
     return;
   }
 
-  plotsCollection plots;
-
   QModelIndexList selection = ui->logTable->selectionModel()->selectedRows();
-  int rowCount = selection.length();
-  bool hasLogSelection;
-  QVarLengthArray<int> selectedRows;
-
-  if (rowCount) {
-    hasLogSelection = true;
-    foreach (QModelIndex index, selection) {
-      selectedRows.append(index.row());
-    }
-    std::sort(selectedRows.begin(), selectedRows.end());
-  } else {
-    hasLogSelection = false;
-    rowCount = ui->logTable->rowCount();
+  QVector<int> selectedRows;
+
+  foreach (QModelIndex index, selection) {
+    selectedRows.append(index.row());
   }
+  std::sort(selectedRows.begin(), selectedRows.end());
 
+  // the columns are parsed once when loading, only the selected rows are copied
+  auto selectedValues = [&](const QVector<double> & values) {
+    if (selectedRows.isEmpty()) {
+      return values;
+    }
+    QVector<double> result;
+    result.reserve(selectedRows.size());
+    for (int row : selectedRows) {
+      result.append(values.at(row));
+    }
+    return result;
+  };
+
+  plots.coords.clear();
   plots.min_x = QDateTime::currentDateTime().toTime_t();
   plots.max_x = 0;
 
+  QVector<double> times = selectedValues(logData->times());
+  for (double time : times) {
+    if (plots.min_x > time) plots.min_x = time;
+    if (plots.max_x < time) plots.max_x = time;
+  }
+
   foreach (QTableWidgetItem *plot, ui->FieldsTW->selectedItems()) {
     coords_t plotCoords;
     int plotColumn = plot->row() + 2; // Date and Time first
@@ -847,41 +820,12 @@ void LogsDialog::plotLogs()
     plotCoords.max_y = INVALID_MAX;
     plotCoords.yaxis = firstLeft;
     plotCoords.name = plot->text();
+    plotCoords.x = times;
+    plotCoords.y = selectedValues(logData->values(plotColumn));
 
-    for (int row = 0; row < rowCount; row++) {
-      QTableWidgetItem *logValue;
-      double y;
-      double time;
-      QString time_str;
-
-      if (hasLogSelection) {
-        logValue = ui->logTable->item(selectedRows.at(row), plotColumn);
-        time_str = ui->logTable->item(selectedRows.at(row), 0)->text() +
-          QString(" ") + ui->logTable->item(selectedRows.at(row), 1)->text();
-      } else {
-        logValue = ui->logTable->item(row, plotColumn);
-        time_str = ui->logTable->item(row, 0)->text() + QString(" ") +
-          ui->logTable->item(row, 1)->text();
-      }
-
-      y = logValue->text().toDouble();
-      plotCoords.y.push_back(y);
-
+    for (double y : plotCoords.y) {
       if (plotCoords.min_y > y) plotCoords.min_y = y;
       if (plotCoords.max_y < y) plotCoords.max_y = y;
-
-      if (time_str.contains('.')) {
-        time = QDateTime::fromString(time_str, "yyyy-MM-dd HH:mm:ss.zzz")
-          .toTime_t();
-        time += time_str.mid(time_str.indexOf('.')).toDouble();
-      } else {
-        time = QDateTime::fromString(time_str, "yyyy-MM-dd HH:mm:ss")
-          .toTime_t();
-      }
-      plotCoords.x.push_back(time);
-
-      if (plots.min_x > time) plots.min_x = time;
-      if (plots.max_x < time) plots.max_x = time;
     }
 
     double range_inc = (plotCoords.max_y - plotCoords.min_y) / 100;
@@ -1045,8 +989,7 @@ void LogsDialog::plotLogs()
         break;
     }
 
-    ui->customPlot->graph(i)->setData(plots.coords.at(i).x,
-      plots.coords.at(i).y);
+    updateGraphData(i);
     pen.setColor(colors.at(i % colors.size()));
     ui->customPlot->graph(i)->setPen(pen);
 
@@ -1066,6 +1009,74 @@ void LogsDialog::plotLogs()
   ui->customPlot->replot();
 }
 
+void LogsDialog::xAxisChangeRange(QCPRange range)
+{
+  // graphs are still being created
+  if (ui->customPlot->graphCount() != plots.coords.size()) return;
+
+  for (int i = 0; i < plots.coords.size(); i++) {
+    updateGraphData(i);
+  }
+}
+
+void LogsDialog::updateGraphData(int index)
+{
+  const coords_t & c = plots.coords.at(index);
+  QCPGraph * graph = ui->customPlot->graph(index);
+  QCPRange range = axisRect->axis(QCPAxis::atBottom)->range();
+  int buckets = qMax(axisRect->width(), 100);
+  double bucketWidth = range.size() / buckets;
+
+  // not worth reducing, give all points once
+  if (c.x.size() <= 4 * buckets || bucketWidth <= 0) {
+    if (graph->data()->size() != c.x.size()) {
+      graph->setData(c.x, c.y);
+    }
+    return;
+  }
+
+  // keep the lowest and the highest point of each pixel column, and the
+  // closest points outside of the range so that lines go up to the edges
+  QVector<int> lowest(buckets, -1);
+  QVector<int> highest(buckets, -1);
+  int before = -1;
+  int after = -1;
+
+  for (int i = 0; i < c.x.size(); i++) {
+    double key = c.x.at(i);
+    if (key < range.lower) {
+      if (before < 0 || key > c.x.at(before)) before = i;
+    }
+    else if (key > range.upper) {
+      if (after < 0 || key < c.x.at(after)) after = i;
+    }
+    else {
+      int bucket = qMin(int((key - range.lower) / bucketWidth), buckets - 1);
+      if (lowest[bucket] < 0 || c.y.at(i) < c.y.at(lowest[bucket])) lowest[bucket] = i;
+      if (highest[bucket] < 0 || c.y.at(i) > c.y.at(highest[bucket])) highest[bucket] = i;
+    }
+  }
+
+  QVector<double> x, y;
+  x.reserve(2 * buckets + 2);
+  y.reserve(2 * buckets + 2);
+
+  auto addPoint = [&](int i) {
+    x.append(c.x.at(i));
+    y.append(c.y.at(i));
+  };
+
+  if (before >= 0) addPoint(before);
+  for (int bucket = 0; bucket < buckets; bucket++) {
+    if (lowest[bucket] < 0) continue;
+    addPoint(lowest[bucket]);
+    if (highest[bucket] != lowest[bucket]) addPoint(highest[bucket]);
+  }
+  if (after >= 0) addPoint(after);
+
+  graph->setData(x, y);
+}
+
 void LogsDialog::yAxisChangeRanges(QCPRange range)
 {
   if (axisRect->axis(QCPAxis::atRight)->visible()) {
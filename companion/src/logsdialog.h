@@ -24,6 +24,7 @@
 #include <QtCore>
 #include <QDialog>
 #include "qcustomplot.h"
+#include "logdata.h"
 
 #define INVALID_MIN 999999
 #define INVALID_MAX -999999
@@ -32,6 +33,8 @@ namespace Ui {
   class LogsDialog;
 }
 
+class QProgressDialog;
+
 class LogsDialog : public QDialog
 {
   Q_OBJECT
@@ -82,10 +85,17 @@ private slots:
   void on_sessions_CB_currentIndexChanged(int index);
   void on_mapsButton_clicked();
   void yAxisChangeRanges(QCPRange range);
+  void xAxisChangeRange(QCPRange range);
+  void onLogLoaded(int result);
 
 private:
-  QList<QStringList> csvlog;
   Ui::LogsDialog *ui;
+  LogData *logData;
+  LogTableModel *logModel;
+  LogData *loadingData;
+  LogLoader *logLoader;
+  QThread *loadThread;
+  QProgressDialog *loadProgress;
   QCPAxisRect *axisRect;
   QCPLegend *rightLegend;
   bool plotLock;
@@ -102,12 +112,15 @@ private:
   QCPItemTracer * cursorB;
   QCPItemStraightLine * cursorLine;
 
-  bool cvsFileParse();
-  QList<QStringList> filterGePoints(const QList<QStringList> & input);
+  plotsCollection plots;
+
+  void loadLogFile(const QString & fileName);
+  void finishLoading();
+  bool filterGePoints(QVector<int> & rows);
   void exportToGoogleEarth();
-  QDateTime getRecordTimeStamp(int index);
   QString generateDuration(const QDateTime & start, const QDateTime & end);
   void setFlightSessions();
+  void updateGraphData(int index);
 
   void addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph);
   void countNumberOfThrows(const coords_t & c, QCPGraph * graph);
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "strhelpers.h"
@@ -469,6 +470,12 @@ VfsError VfsDir::rewind()
 }
 
 void VfsFile::clear() {
+#if !defined(BOOT)
+  // a file opened again without being closed keeps neither its pending
+  // data nor its buffer
+  flushWriteBuffer();
+  writeBuffer.release();
+#endif
   type = VfsFileType::UNKNOWN;
 #if defined(USE_LITTLEFS)
   lfs.file = {0};
@@ -480,6 +487,10 @@ void VfsFile::clear() {
 VfsError VfsFile::close()
 {
   VfsError ret = VfsError::INVAL;
+#if !defined(BOOT)
+  VfsError flushed = flushWriteBuffer();
+  writeBuffer.release();
+#endif
   switch(type)
   {
 #if defined (USE_FATFS)
@@ -494,12 +505,19 @@ VfsError VfsFile::close()
 #endif
   }
 
+#if !defined(BOOT)
+  if (ret == VfsError::OK)
+    ret = flushed;
+#endif
   clear();
   return ret;
 }
 
 int VfsFile::size()
 {
+#if !defined(BOOT)
+  flushWriteBuffer();
+#endif
   switch(type)
   {
 #if defined (USE_FATFS)
@@ -523,6 +541,13 @@ int VfsFile::size()
 
 VfsError VfsFile::read(void* buf, size_t size, size_t& readSize)
 {
+#if !defined(BOOT)
+  VfsError flushed = flushWriteBuffer();
+  if (flushed != VfsError::OK) {
+    readSize = 0;
+    return flushed;
+  }
+#endif
   switch(type)
   {
 #if defined (USE_FATFS)
@@ -555,6 +580,10 @@ VfsError VfsFile::read(void* buf, size_t size, size_t& readSize)
 
 char* VfsFile::gets(char* buf, size_t maxLen)
 {
+#if !defined(BOOT)
+  if (flushWriteBuffer() != VfsError::OK)
+    return 0;
+#endif
   switch(type)
   {
 #if defined (USE_FATFS)
@@ -587,7 +616,7 @@ char* VfsFile::gets(char* buf, size_t maxLen)
 }
 
 #if !defined(BOOT)
-VfsError VfsFile::write(const void* buf, size_t size, size_t& written)
+VfsError VfsFile::writeDirect(const void* buf, size_t size, size_t& written)
 {
   switch(type)
   {
@@ -616,9 +645,108 @@ VfsError VfsFile::write(const void* buf, size_t size, size_t& written)
 #endif
   }
 
+  written = 0;
   return VfsError::INVAL;
 }
 
+VfsError VfsFile::writeDirect(void* ctx, const void* buf, size_t size, size_t& written)
+{
+  return static_cast<VfsFile*>(ctx)->writeDirect(buf, size, written);
+}
+
+VfsError VfsFile::flushWriteBuffer()
+{
+  return writeBuffer.flush(writeDirect, this);
+}
+
+// FatFs already buffers a sector in each FIL, only LittleFS writes are
+// gathered in writeBuffer. Errors of buffered writes are returned by the
+// write which flushes them or close().
+VfsError VfsFile::write(const void* buf, size_t size, size_t& written)
+{
+  if (type != VfsFileType::LFS)
+    return writeDirect(buf, size, written);
+
+  return writeBuffer.write(buf, size, tell(), written, writeDirect, this);
+}
+
+VfsError VfsWriteBuffer::flush(Sink sink, void* ctx)
+{
+  if (count == 0)
+    return VfsError::OK;
+
+  size_t written;
+  VfsError ret = sink(ctx, buffer, count, written);
+  if (ret == VfsError::OK && written != count)
+    ret = VfsError::NOSPC;
+
+  count = 0;
+  limit = 0;
+  return ret;
+}
+
+VfsError VfsWriteBuffer::write(const void* buf, size_t size, size_t position,
+                               size_t& written, Sink sink, void* ctx)
+{
+  written = 0;
+
+  auto data = static_cast<const uint8_t*>(buf);
+
+  while (size > 0) {
+    if (count == 0) {
+      limit = VFS_WRITE_BUFFER_SIZE - position % VFS_WRITE_BUFFER_SIZE;
+
+      if (size >= limit) {
+        size_t direct = size - (size - limit) % VFS_WRITE_BUFFER_SIZE;
+        size_t wrt;
+        VfsError ret = sink(ctx, data, direct, wrt);
+        written += wrt;
+        if (ret != VfsError::OK || wrt != direct)
+          return ret;
+        data += direct;
+        size -= direct;
+        position += direct;
+        continue;
+      }
+
+      if (!buffer) {
+        buffer = (uint8_t*)malloc(VFS_WRITE_BUFFER_SIZE);
+        if (!buffer) {
+          // no buffering then
+          size_t wrt;
+          VfsError ret = sink(ctx, data, size, wrt);
+          written += wrt;
+          return ret;
+        }
+      }
+    }
+
+    size_t n = min<size_t>(size, limit - count);
+    memcpy(buffer + count, data, n);
+    count += n;
+    written += n;
+    data += n;
+    size -= n;
+    position += n;
+
+    if (count == limit) {
+      VfsError ret = flush(sink, ctx);
+      if (ret != VfsError::OK)
+        return ret;
+    }
+  }
+
+  return VfsError::OK;
+}
+
+void VfsWriteBuffer::release()
+{
+  free(buffer);
+  buffer = nullptr;
+  count = 0;
+  limit = 0;
+}
+
 VfsError VfsFile::puts(const std::string& str)
 {
   size_t written;
@@ -628,138 +756,175 @@ VfsError VfsFile::puts(const std::string& str)
 VfsError VfsFile::putc(char c)
 {
   size_t written;
-  return this->write(&c, 1, written);
+  VfsError ret = this->write(&c, 1, written);
+  if (ret == VfsError::OK && written != 1)
+    ret = VfsError::NOSPC;
+  return ret;
 }
 
-int VfsFile::fprintf(const char* str, ...)
-{
-  switch(type)
-  {
-#if defined (USE_FATFS)
-  case VfsFileType::FAT:
-  {
-      va_list args;
-      va_start(args, str);
+// Same subset as FatFs f_printf(), for all the file systems:
+// %[0|-][width|*][l](c|s|b|o|d|u|x|X), anything else is output as is.
+// Returns the number of characters written, or EOF on error
+int VfsFile::fprintf(const char* fmt, ...)
+{
+  if (!isOpen())
+    return EOF;
+
+  va_list args;
+  va_start(args, fmt);
+
+  int count = 0;
+  bool failed = false;
+  char buf[32];
+  char c;
+
+  // the output goes to the file in chunks, as f_printf() does
+  char out[64];
+  size_t outCount = 0;
+
+  auto flush = [&]() {
+    size_t written;
+    if (!failed && outCount > 0 &&
+        (write(out, outCount, written) != VfsError::OK || written != outCount))
+      failed = true;
+    outCount = 0;
+  };
+
+  auto output = [&](char ch) {
+    out[outCount++] = ch;
+    count++;
+    if (outCount == sizeof(out))
+      flush();
+  };
+
+  while ((c = *fmt++) != 0) {
+    if (c != '%') {
+      output(c);
+      continue;
+    }
+
+    uint8_t flags = 0;  // 1: '0' padding, 2: left justified, 4: long, 8: negative
+    unsigned width = 0;
+    c = *fmt++;
+    if (c == '0') {
+      flags = 1;
+      c = *fmt++;
+    }
+    else if (c == '-') {
+      flags = 2;
+      c = *fmt++;
+    }
+    if (c == '*') {
+      width = va_arg(args, int);
+      c = *fmt++;
+    }
+    else {
+      while (c >= '0' && c <= '9') {
+        width = width * 10 + c - '0';
+        c = *fmt++;
+      }
+    }
+    if (c == 'l' || c == 'L') {
+      flags |= 4;
+      c = *fmt++;
+    }
+    if (c == 0)
+      break;
+
+    char type = (c >= 'a' && c <= 'z') ? c - 0x20 : c;
+    unsigned radix;
+    switch (type) {
+      case 'S': {
+        const char* str = va_arg(args, const char*);
+        unsigned len = strlen(str);
+        for (unsigned i = len; !(flags & 2) && i < width; i++)
+          output(' ');
+        while (*str)
+          output(*str++);
+        for (unsigned i = len; (flags & 2) && i < width; i++)
+          output(' ');
+        continue;
+      }
+
+      case 'C':
+        output((char)va_arg(args, int));
+        continue;
+
+      case 'B':
+        radix = 2;
+        break;
+
+      case 'O':
+        radix = 8;
+        break;
+
+      case 'D':
+      case 'U':
+        radix = 10;
+        break;
+
+      case 'X':
+        radix = 16;
+        break;
 
-      int ret = f_printf(&fat.file, str, args);
-      va_end(args);
-      return ret;
+      default:
+        output(c);
+        continue;
+    }
+
+    uint32_t value;
+    if (flags & 4)
+      value = (uint32_t)va_arg(args, long);
+    else if (type == 'D')
+      value = (uint32_t)va_arg(args, int);
+    else
+      value = va_arg(args, unsigned int);
+
+    if (type == 'D' && (value & 0x80000000)) {
+      value = 0 - value;
+      flags |= 8;
+    }
+
+    unsigned len = 0;
+    do {
+      char digit = value % radix;
+      value /= radix;
+      buf[len++] = digit + (digit > 9 ? (c == 'x' ? 'a' - 10 : 'A' - 10) : '0');
+    } while (value && len < sizeof(buf) - 1);
+    if (flags & 8)
+      buf[len++] = '-';
+
+    char pad = (flags & 1) ? '0' : ' ';
+    if ((flags & 9) == 9) {
+      // the sign goes before the zero padding
+      output(buf[--len]);
+      if (width > 0)
+        width--;
+    }
+    for (unsigned i = len; !(flags & 2) && i < width; i++)
+      output(pad);
+    for (unsigned i = len; i > 0; i--)
+      output(buf[i - 1]);
+    for (unsigned i = len; (flags & 2) && i < width; i++)
+      output(pad);
   }
-#endif
-#if defined(USE_LITTLEFS)
-  case VfsFileType::LFS:
-  {
-#if 0
-      va_list arp;
-         putbuff pb;
-         BYTE f, r;
-         UINT i, j, w;
-         DWORD v;
-         TCHAR c, d, str[32], *p;
-
-
-         putc_init(&pb, fp);
-
-         va_start(arp, fmt);
-
-         for (;;) {
-             c = *fmt++;
-             if (c == 0) break;          /* End of string */
-             if (c != '%') {             /* Non escape character */
-                 putc_bfd(&pb, c);
-                 continue;
-             }
-             w = f = 0;
-             c = *fmt++;
-             if (c == '0') {             /* Flag: '0' padding */
-                 f = 1; c = *fmt++;
-             } else {
-                 if (c == '-') {         /* Flag: left justified */
-                     f = 2; c = *fmt++;
-                 }
-             }
-             if (c == '*') {             /* Minimum width by argument */
-                 w = va_arg(arp, int);
-                 c = *fmt++;
-             } else {
-                 while (IsDigit(c)) {    /* Minimum width */
-                     w = w * 10 + c - '0';
-                     c = *fmt++;
-                 }
-             }
-             if (c == 'l' || c == 'L') { /* Type prefix: Size is long int */
-                 f |= 4; c = *fmt++;
-             }
-             if (c == 0) break;
-             d = c;
-             if (IsLower(d)) d -= 0x20;
-             switch (d) {                /* Atgument type is... */
-             case 'S' :                  /* String */
-                 p = va_arg(arp, TCHAR*);
-                 for (j = 0; p[j]; j++) ;
-                 if (!(f & 2)) {                     /* Right padded */
-                     while (j++ < w) putc_bfd(&pb, ' ') ;
-                 }
-                 while (*p) putc_bfd(&pb, *p++) ;        /* String body */
-                 while (j++ < w) putc_bfd(&pb, ' ') ;    /* Left padded */
-                 continue;
-
-             case 'C' :                  /* Character */
-                 putc_bfd(&pb, (TCHAR)va_arg(arp, int)); continue;
-
-             case 'B' :                  /* Unsigned binary */
-                 r = 2; break;
-
-             case 'O' :                  /* Unsigned octal */
-                 r = 8; break;
-
-             case 'D' :                  /* Signed decimal */
-             case 'U' :                  /* Unsigned decimal */
-                 r = 10; break;
-
-             case 'X' :                  /* Unsigned hexdecimal */
-                 r = 16; break;
-
-             default:                    /* Unknown type (pass-through) */
-                 putc_bfd(&pb, c); continue;
-             }
-
-             /* Get an argument and put it in numeral */
-             v = (f & 4) ? (DWORD)va_arg(arp, long) : ((d == 'D') ? (DWORD)(long)va_arg(arp, int) : (DWORD)va_arg(arp, unsigned int));
-             if (d == 'D' && (v & 0x80000000)) {
-                 v = 0 - v;
-                 f |= 8;
-             }
-             i = 0;
-             do {
-                 d = (TCHAR)(v % r); v /= r;
-                 if (d > 9) d += (c == 'x') ? 0x27 : 0x07;
-                 str[i++] = d + '0';
-             } while (v && i < sizeof str / sizeof *str);
-             if (f & 8) str[i++] = '-';
-             j = i; d = (f & 1) ? '0' : ' ';
-             if (!(f & 2)) {
-                 while (j++ < w) putc_bfd(&pb, d);   /* Right pad */
-             }
-             do {
-                 putc_bfd(&pb, str[--i]);            /* Number body */
-             } while (i);
-             while (j++ < w) putc_bfd(&pb, d);       /* Left pad */
-         }
-
-         va_end(arp);
-
-         return putc_flush(&pb);
-#endif
-  }
-#endif
-  }
-
-  return (int)VfsError::INVAL;
+
+  va_end(args);
+  flush();
+  return failed ? EOF : count;
 }
 #endif
 
 size_t VfsFile::tell()
+{
+#if !defined(BOOT)
+  return tellDirect() + writeBuffer.pending();
+#else
+  return tellDirect();
+#endif
+}
+
+size_t VfsFile::tellDirect()
 {
     switch(type)
     {
@@ -784,6 +949,11 @@ size_t VfsFile::tell()
 
 VfsError VfsFile::lseek(size_t offset)
 {
+#if !defined(BOOT)
+  VfsError flushed = flushWriteBuffer();
+  if (flushed != VfsError::OK)
+    return flushed;
+#endif
   switch(type)
   {
 #if defined (USE_FATFS)
@@ -808,6 +978,9 @@ VfsError VfsFile::lseek(size_t offset)
 
 int VfsFile::eof()
 {
+#if !defined(BOOT)
+  flushWriteBuffer();
+#endif
   switch(type)
   {
 #if defined (USE_FATFS)
@@ -879,6 +1052,9 @@ void VirtualFS::stop()
   audioQueue.stopSD();
 #if defined (SDCARD)
   if (sdCardMounted()) {
+#if defined(DISK_CACHE_WRITEBACK) && !defined(BOOT)
+    diskCache[0].setWriteBack(0, false);
+#endif
     f_mount(nullptr, "", 0); // unmount SD
   }
 #endif
@@ -981,6 +1157,9 @@ void VirtualFS::mountSd()
 
 #if defined(DISK_CACHE) && !defined(BOOT)
   diskCache[0].clear();
+#if defined(DISK_CACHE_WRITEBACK)
+  diskCache[0].setWriteBack(0, true);
+#endif
 #endif
 
   if (f_mount(&sdFatFs, "", 1) == FR_OK) {
@@ -1877,10 +2056,13 @@ void VirtualFS::startLogs()
     return;
 #if defined(SDCARD)
 #if defined(LOG_TELEMETRY)
-  openFile(g_telemetryFile, LOGS_PATH "/telemetry.log", VfsOpenFlags::OPEN_ALWAYS | VfsOpenFlagsWRITE);
+  openFile(g_telemetryFile, LOGS_PATH "/telemetry.bin", VfsOpenFlags::OPEN_ALWAYS | VfsOpenFlags::WRITE);
   if (g_telemetryFile.size() > 0) {
     g_telemetryFile.lseek(g_telemetryFile.size()); // append
   }
+#if !defined(SIMU)
+  logTelemetryOpen();
+#endif
 #endif
 
 #if defined(LOG_BLUETOOTH)
@@ -1896,6 +2078,9 @@ void VirtualFS::stopLogs()
 {
 #if defined(SDCARD)
 #if defined(LOG_TELEMETRY)
+#if !defined(SIMU)
+  logTelemetryClose();
+#endif
   g_telemetryFile.close();
 #endif
 
@@ -84,6 +84,9 @@
 #endif
 
 #define VFS_MAX_LFN      255
+// small writes to LittleFS files are gathered into writes of that size
+// (a whole number of pages) aligned on the file position
+#define VFS_WRITE_BUFFER_SIZE  512
 constexpr uint8_t LEN_FILE_EXTENSION_MAX = 5;  // longest used, including the dot, excluding null term.
 
 #define FILE_COPY_PREFIX "cp_"
@@ -95,6 +98,7 @@ constexpr uint8_t LEN_FILE_EXTENSION_MAX = 5;  // longest used, including the do
 #define MODELS_PATH         ROOT_PATH "MODELS"      // no trailing slash = important
 #define DELETED_MODELS_PATH MODELS_PATH PATH_SEPARATOR "DELETED"
 #define UNUSED_MODELS_PATH  MODELS_PATH PATH_SEPARATOR "UNUSED"
+#define MODELS_CACHE_PATH   MODELS_PATH PATH_SEPARATOR "CACHE"
 #define RADIO_PATH          ROOT_PATH "RADIO"       // no trailing slash = important
 #define TEMPLATES_PATH      ROOT_PATH "TEMPLATES"
 #define PERS_TEMPL_PATH     TEMPLATES_PATH "/PERSONAL"
@@ -119,6 +123,7 @@ constexpr uint8_t LEN_FILE_EXTENSION_MAX = 5;  // longest used, including the do
 #define SCRIPTS_FUNCS_PATH  SCRIPTS_PATH PATH_SEPARATOR "FUNCTIONS"
 #define SCRIPTS_TELEM_PATH  SCRIPTS_PATH PATH_SEPARATOR "TELEMETRY"
 #define SCRIPTS_TOOLS_PATH  SCRIPTS_PATH PATH_SEPARATOR "TOOLS"
+#define SCRIPTS_BUNDLE_FILE SCRIPTS_PATH PATH_SEPARATOR "BUNDLE.bin"
 
 #define SDCARD_FIRMWARES_PATH      SDCARD_PATH PATH_SEPARATOR "FIRMWARE"
 #define INTERNAL_ST_FIRMWARES_PATH INTERNAL_ST_PATH PATH_SEPARATOR "FIRMWARE"
@@ -147,6 +152,7 @@ const char YAMLFILE_CHECKSUM_TAG_NAME[] = "checksum";
 
 #define MODELS_EXT          ".bin"
 #define LOGS_EXT            ".csv"
+#define LOGS_BIN_EXT        ".etl"
 #define SOUNDS_EXT          ".wav"
 #define BMP_EXT             ".bmp"
 #define PNG_EXT             ".png"
@@ -161,6 +167,7 @@ const char YAMLFILE_CHECKSUM_TAG_NAME[] = "checksum";
 #define MULTI_FIRMWARE_EXT  ".bin"
 #define ELRS_FIRMWARE_EXT   ".elrs"
 #define YAML_EXT            ".yml"
+#define MODELS_CACHE_EXT    ".bin"
 
 #if defined(COLORLCD)
 #define BITMAPS_EXT         BMP_EXT JPG_EXT PNG_EXT
@@ -311,6 +318,31 @@ private:
   size_t readIdx = 0;
 };
 
+#if !defined(BOOT)
+// Gathers small writes into writes of VFS_WRITE_BUFFER_SIZE aligned on the
+// file position, data which already spans whole blocks goes straight to the
+// sink. The buffer is allocated by the first buffered write.
+class VfsWriteBuffer
+{
+public:
+  typedef VfsError (*Sink)(void* ctx, const void* buf, size_t size, size_t& written);
+
+  // position: file position of the first byte of buf
+  VfsError write(const void* buf, size_t size, size_t position, size_t& written,
+                 Sink sink, void* ctx);
+  VfsError flush(Sink sink, void* ctx);
+  // frees the buffer, flush() first to keep the pending data
+  void release();
+
+  size_t pending() const { return count; }
+
+private:
+  uint8_t* buffer = nullptr;
+  size_t count = 0;
+  size_t limit = 0;  // bytes up to the next aligned position
+};
+#endif
+
 // for compatibility reasons (audio.h WavContext) the file does not close it self when destructed
 // since the must not be a non trivial destructor
 struct VfsFile
@@ -340,6 +372,15 @@ private:
   VfsFile(const VfsFile&);
 
   void clear();
+  size_t tellDirect();
+#if !defined(BOOT)
+  VfsError writeDirect(const void* buf, size_t size, size_t& written);
+  static VfsError writeDirect(void* ctx, const void* buf, size_t size, size_t& written);
+  VfsError flushWriteBuffer();
+
+  // LittleFS only, released by close()
+  VfsWriteBuffer writeBuffer;
+#endif
 
   VfsFileType type = VfsFileType::UNKNOWN;
   union {
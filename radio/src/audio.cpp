@@ -548,93 +548,253 @@ inline void mixSample(audio_data_t * result, int sample, unsigned int fade)
 }
 
 #define RIFF_CHUNK_SIZE 12
-uint8_t wavBuffer[AUDIO_BUFFER_SIZE*2] __DMA;
+
+// Catmull-Rom interpolation coefficients (Q14) for each of the resampler
+// phases, applied to the samples around the output position
+#define WAV_PHASES_BITS         6
+#define WAV_COEFS_SHIFT         14
+static const int16_t wavResamplerCoefs[1 << WAV_PHASES_BITS][4] = {
+  {      0,  16384,      0,      0 },
+  {   -124,  16374,    136,     -2 },
+  {   -240,  16345,    287,     -8 },
+  {   -349,  16297,    453,    -17 },
+  {   -450,  16230,    634,    -30 },
+  {   -544,  16146,    828,    -46 },
+  {   -631,  16044,   1036,    -65 },
+  {   -711,  15926,   1256,    -87 },
+  {   -784,  15792,   1488,   -112 },
+  {   -851,  15642,   1732,   -139 },
+  {   -911,  15478,   1986,   -169 },
+  {   -966,  15299,   2251,   -200 },
+  {  -1014,  15106,   2526,   -234 },
+  {  -1057,  14900,   2810,   -269 },
+  {  -1094,  14681,   3103,   -306 },
+  {  -1125,  14450,   3404,   -345 },
+  {  -1152,  14208,   3712,   -384 },
+  {  -1174,  13955,   4027,   -424 },
+  {  -1190,  13691,   4349,   -466 },
+  {  -1202,  13417,   4677,   -508 },
+  {  -1210,  13134,   5010,   -550 },
+  {  -1213,  12842,   5348,   -593 },
+  {  -1213,  12542,   5690,   -635 },
+  {  -1208,  12235,   6035,   -678 },
+  {  -1200,  11920,   6384,   -720 },
+  {  -1188,  11599,   6735,   -762 },
+  {  -1173,  11272,   7088,   -803 },
+  {  -1155,  10939,   7443,   -843 },
+  {  -1134,  10602,   7798,   -882 },
+  {  -1110,  10260,   8154,   -920 },
+  {  -1084,   9915,   8509,   -956 },
+  {  -1055,   9567,   8863,   -991 },
+  {  -1024,   9216,   9216,  -1024 },
+  {   -991,   8863,   9567,  -1055 },
+  {   -956,   8509,   9915,  -1084 },
+  {   -920,   8154,  10260,  -1110 },
+  {   -882,   7798,  10602,  -1134 },
+  {   -843,   7443,  10939,  -1155 },
+  {   -803,   7088,  11272,  -1173 },
+  {   -762,   6735,  11599,  -1188 },
+  {   -720,   6384,  11920,  -1200 },
+  {   -678,   6035,  12235,  -1208 },
+  {   -635,   5690,  12542,  -1213 },
+  {   -593,   5348,  12842,  -1213 },
+  {   -550,   5010,  13134,  -1210 },
+  {   -508,   4677,  13417,  -1202 },
+  {   -466,   4349,  13691,  -1190 },
+  {   -424,   4027,  13955,  -1174 },
+  {   -384,   3712,  14208,  -1152 },
+  {   -345,   3404,  14450,  -1125 },
+  {   -306,   3103,  14681,  -1094 },
+  {   -269,   2810,  14900,  -1057 },
+  {   -234,   2526,  15106,  -1014 },
+  {   -200,   2251,  15299,   -966 },
+  {   -169,   1986,  15478,   -911 },
+  {   -139,   1732,  15642,   -851 },
+  {   -112,   1488,  15792,   -784 },
+  {    -87,   1256,  15926,   -711 },
+  {    -65,   1036,  16044,   -631 },
+  {    -46,    828,  16146,   -544 },
+  {    -30,    634,  16230,   -450 },
+  {    -17,    453,  16297,   -349 },
+  {     -8,    287,  16345,   -240 },
+  {     -2,    136,  16374,   -124 },
+};
+
+// decoded samples, preceded by the last samples of the previous block
+int16_t wavBuffer[WAV_HISTORY + WAV_MAX_SAMPLES] __DMA;
+
+// Parsed WAV headers of the last played files, most recent first, so that
+// prompts played again (numbers, units, ...) go straight to their samples
+#define WAV_HEADERS_CACHE_SIZE  8
+
+struct WavHeader {
+  uint32_t hash;        // file name hash, 0 when unused
+  uint32_t fileSize;
+  uint32_t dataOffset;
+  uint32_t dataSize;
+  uint32_t freq;
+  uint8_t  codec;
+};
+
+static WavHeader wavHeaders[WAV_HEADERS_CACHE_SIZE];
+
+static uint32_t wavFilenameHash(const char * filename)
+{
+  uint32_t hash = 2166136261u;
+  while (*filename) {
+    hash = (hash ^ (uint8_t)*filename++) * 16777619u;
+  }
+  return hash ? hash : 1;
+}
+
+static VfsError readWavHeader(VfsFile & file, WavHeader & header)
+{
+  uint8_t * buffer = (uint8_t *)wavBuffer;
+  size_t read = 0;
+
+  VfsError result = file.read(buffer, RIFF_CHUNK_SIZE+8, read);
+  if (result != VfsError::OK || read != RIFF_CHUNK_SIZE+8 || memcmp(buffer, "RIFF", 4) || memcmp(buffer+8, "WAVEfmt ", 8)) {
+    return VfsError::INVAL;
+  }
+
+  uint32_t size = *((uint32_t *)(buffer+16));
+  if (size < 16 || size >= 256) {
+    return VfsError::INVAL;
+  }
+  result = file.read(buffer, size+8, read);
+  if (result != VfsError::OK || read != size+8) {
+    return VfsError::INVAL;
+  }
+
+  header.codec = ((uint16_t *)buffer)[0];
+  header.freq = ((uint32_t *)buffer)[1];
+  if ((header.codec != CODEC_ID_PCM_S16LE && header.codec != CODEC_ID_PCM_ALAW && header.codec != CODEC_ID_PCM_MULAW) ||
+      header.freq == 0 || header.freq > WAV_MAX_SAMPLE_RATE) {
+    return VfsError::INVAL;
+  }
+
+  uint32_t * chunk = (uint32_t *)(buffer + size);
+  size = chunk[1];
+  while (memcmp(chunk, "data", 4) != 0) {
+    result = file.lseek(file.tell()+size);
+    if (result != VfsError::OK) {
+      return result;
+    }
+    result = file.read(buffer, 8, read);
+    if (result != VfsError::OK || read != 8) {
+      return VfsError::INVAL;
+    }
+    chunk = (uint32_t *)buffer;
+    size = chunk[1];
+  }
+
+  header.dataOffset = file.tell();
+  header.dataSize = size;
+  return VfsError::OK;
+}
+
+VfsError WavContext::openFile()
+{
+  VfsError result = VirtualFS::instance().openFile(state.file, fragment.file, VfsOpenFlags::OPEN_EXISTING | VfsOpenFlags::READ);
+  if (result != VfsError::OK) {
+    return result;
+  }
+
+  WavHeader header;
+  uint32_t hash = wavFilenameHash(fragment.file);
+  uint32_t fileSize = state.file.size();
+  int index = 0;
+  while (index < WAV_HEADERS_CACHE_SIZE - 1 && !(wavHeaders[index].hash == hash && wavHeaders[index].fileSize == fileSize)) {
+    index++;
+  }
+
+  if (wavHeaders[index].hash == hash && wavHeaders[index].fileSize == fileSize) {
+    header = wavHeaders[index];
+    result = state.file.lseek(header.dataOffset);
+  }
+  else {
+    // the least recently used entry is replaced
+    result = readWavHeader(state.file, header);
+    header.hash = hash;
+    header.fileSize = fileSize;
+  }
+  if (result != VfsError::OK) {
+    return result;
+  }
+
+  memmove(&wavHeaders[1], &wavHeaders[0], index * sizeof(WavHeader));
+  wavHeaders[0] = header;
+
+  state.codec = header.codec;
+  state.freq = header.freq;
+  state.size = header.dataSize;
+  state.step = ((header.freq << 16) + AUDIO_SAMPLE_RATE / 2) / AUDIO_SAMPLE_RATE;
+  // the first output sample is the first sample of the file
+  state.position = (WAV_HISTORY - 1) << 16;
+  memset(state.history, 0, sizeof(state.history));
+  return VfsError::OK;
+}
 
 int WavContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
 {
   VfsError result = VfsError::OK;
-  size_t read = 0;
-  VirtualFS& vfs = VirtualFS::instance();
 
   if (fragment.file[1]) {
-    result = vfs.openFile(state.file, fragment.file, VfsOpenFlags::OPEN_EXISTING | VfsOpenFlags::READ);
+    result = openFile();
     fragment.file[1] = 0;
-    if (result == VfsError::OK) {
-      result = state.file.read(wavBuffer, RIFF_CHUNK_SIZE+8, read);
-      if (result == VfsError::OK && read == RIFF_CHUNK_SIZE+8 && !memcmp(wavBuffer, "RIFF", 4) && !memcmp(wavBuffer+8, "WAVEfmt ", 8)) {
-        uint32_t size = *((uint32_t *)(wavBuffer+16));
-        result = (size < 256 ? state.file.read(wavBuffer, size+8, read) : VfsError::INVAL);
-        if (result == VfsError::OK && read == size+8) {
-          state.codec = ((uint16_t *)wavBuffer)[0];
-          state.freq = ((uint16_t *)wavBuffer)[2];
-          uint32_t *wavSamplesPtr = (uint32_t *)(wavBuffer + size);
-          uint32_t size = wavSamplesPtr[1];
-          if (state.freq != 0 && state.freq * (AUDIO_SAMPLE_RATE / state.freq) == AUDIO_SAMPLE_RATE) {
-            state.resampleRatio = (AUDIO_SAMPLE_RATE / state.freq);
-            state.readSize = (state.codec == CODEC_ID_PCM_S16LE ? 2*AUDIO_BUFFER_SIZE : AUDIO_BUFFER_SIZE) / state.resampleRatio;
-          }
-          else {
-            result = VfsError::INVAL;
-          }
-          while (result == VfsError::OK && memcmp(wavSamplesPtr, "data", 4) != 0) {
-            result = state.file.lseek(state.file.tell()+size);
-            if (result == VfsError::OK) {
-              result = state.file.read(wavBuffer, 8, read);
-              if (read != 8) result = VfsError::INVAL;
-              wavSamplesPtr = (uint32_t *)wavBuffer;
-              size = wavSamplesPtr[1];
-            }
-          }
-          state.size = size;
-        }
-        else {
-          result = VfsError::INVAL;
-        }
-      }
-      else {
-        result = VfsError::INVAL;
-      }
-    }
   }
 
   if (result == VfsError::OK) {
-    read = 0;
-    result = state.file.read(wavBuffer, state.readSize, read);
+    // input samples needed to fill the buffer
+    uint32_t count = (state.position + (AUDIO_BUFFER_SIZE - 1) * state.step) >> 16;
+    uint32_t sampleSize = (state.codec == CODEC_ID_PCM_S16LE ? 2 : 1);
+    uint32_t readSize = min<uint32_t>(count, WAV_MAX_SAMPLES) * sampleSize;
+    int16_t * pcm = &wavBuffer[WAV_HISTORY];
+    // 8 bits samples are read in the upper part of the buffer and expanded in place
+    uint8_t * data = (sampleSize == 2 ? (uint8_t *)pcm : (uint8_t *)pcm + WAV_MAX_SAMPLES);
+    size_t read = 0;
+
+    result = state.file.read(data, readSize, read);
     if (result == VfsError::OK) {
       if (read > state.size) {
         read = state.size;
       }
       state.size -= read;
 
-      if (read != state.readSize) {
+      if (read != readSize) {
         state.file.close();
         fragment.clear();
       }
 
-      audio_data_t * samples = buffer->data;
-      if (state.codec == CODEC_ID_PCM_S16LE) {
-        read /= 2;
-        for (uint32_t i=0; i<read; i++) {
-          for (uint8_t j=0; j<state.resampleRatio; j++) {
-            mixSample(samples++, ((int16_t *)wavBuffer)[i], fade+2-volume);
-          }
-        }
-      }
-      else if (state.codec == CODEC_ID_PCM_ALAW) {
-        for (uint32_t i=0; i<read; i++) {
-          for (uint8_t j=0; j<state.resampleRatio; j++) {
-            mixSample(samples++, alawTable[wavBuffer[i]], fade+2-volume);
-          }
+      count = read / sampleSize;
+      if (state.codec == CODEC_ID_PCM_ALAW) {
+        for (uint32_t i = 0; i < count; i++) {
+          pcm[i] = alawTable[data[i]];
         }
       }
       else if (state.codec == CODEC_ID_PCM_MULAW) {
-        for (uint32_t i=0; i<read; i++) {
-          for (uint8_t j=0; j<state.resampleRatio; j++) {
-            mixSample(samples++, ulawTable[wavBuffer[i]], fade+2-volume);
-          }
+        for (uint32_t i = 0; i < count; i++) {
+          pcm[i] = ulawTable[data[i]];
         }
       }
 
+      memcpy(wavBuffer, state.history, sizeof(state.history));
+
+      audio_data_t * samples = buffer->data;
+      audio_data_t * end = samples + AUDIO_BUFFER_SIZE;
+      unsigned int shift = fade + 2 - volume;
+      uint32_t position = state.position;
+      while (samples < end && (position >> 16) + 3 < WAV_HISTORY + count) {
+        const int16_t * input = &wavBuffer[position >> 16];
+        const int16_t * coefs = wavResamplerCoefs[(position & 0xFFFF) >> (16 - WAV_PHASES_BITS)];
+        int sample = (input[0] * coefs[0] + input[1] * coefs[1] + input[2] * coefs[2] + input[3] * coefs[3]) >> WAV_COEFS_SHIFT;
+        mixSample(samples++, sample, shift);
+        position += state.step;
+      }
+
+      state.position = position - (count << 16);
+      memcpy(state.history, &wavBuffer[count], sizeof(state.history));
+
       return samples - buffer->data;
     }
   }
@@ -218,6 +218,12 @@ class ToneContext {
 
 };
 
+// WAV files are resampled to AUDIO_SAMPLE_RATE, their rate is limited by the
+// number of samples which may be decoded for one buffer
+#define WAV_HISTORY                    (4)
+#define WAV_MAX_SAMPLES                (2*AUDIO_BUFFER_SIZE + WAV_HISTORY)
+#define WAV_MAX_SAMPLE_RATE            (2*AUDIO_SAMPLE_RATE)
+
 class WavContext {
   public:
 
@@ -246,9 +252,12 @@ class WavContext {
       uint8_t  codec;
       uint32_t freq;
       uint32_t size;
-      uint8_t  resampleRatio;
-      uint16_t readSize;
+      uint32_t step;      // input samples per output sample (16.16)
+      uint32_t position;  // position of the next output sample in the input (16.16)
+      int16_t  history[WAV_HISTORY];
     } state;
+
+    VfsError openFile();
 };
 
 class MixedContext {
@@ -27,21 +27,39 @@
 
 BinAllocator_slots1 slots1 __SDRAM;
 BinAllocator_slots2 slots2 __SDRAM;
+BinAllocator_slots3 slots3 __SDRAM;
+
+uint32_t binAllocatorFallbacks = 0;
 
 #if defined(DEBUG)
 int SimulateMallocFailure = 0;    //set this to simulate allocation failure
 #endif 
 
+void binAllocatorResetStats()
+{
+  slots1.reset_stats();
+  slots2.reset_stats();
+  slots3.reset_stats();
+  binAllocatorFallbacks = 0;
+}
+
+static size_t bin_size(void * ptr)
+{
+  return slots1.size(ptr) + slots2.size(ptr) + slots3.size(ptr);
+}
+
 bool bin_free(void * ptr)
 {
   //return TRUE if ours
-  return slots1.free(ptr) || slots2.free(ptr);
+  return slots1.free(ptr) || slots2.free(ptr) || slots3.free(ptr);
 }
 
 void * bin_malloc(size_t size) {
-  //try to allocate from our space
+  //try to allocate from our space, smallest slots first
   void * res = slots1.malloc(size);
-  return res ? res : slots2.malloc(size);
+  if (!res) res = slots2.malloc(size);
+  if (!res) res = slots3.malloc(size);
+  return res;
 }
 
 void * bin_realloc(void * ptr, size_t size)
@@ -51,21 +69,26 @@ void * bin_realloc(void * ptr, size_t size)
     return bin_malloc(size);
   }
   else {
-    if (! (slots1.is_member(ptr) || slots2.is_member(ptr)) ) {
+    size_t slot = bin_size(ptr);
+    if (slot == 0) {
       // not our data, leave it to libc realloc
       return 0;
     }
 
     //we have existing data
-    // if it fits in current slot, return it
-    // TODO if new size is smaller, try to relocate in smaller slot
-    if ( slots1.can_fit(ptr, size) ) {
-      // TRACE("OUR realloc %p[%lu] fits in slot1", ptr, size);
-      return ptr;
-    }
-    if ( slots2.can_fit(ptr, size) ) {
-      // TRACE("OUR realloc %p[%lu] fits in slot2", ptr, size);
-      return ptr;
+    if (size <= slot) {
+      // it fits in the current slot, but when it shrank try to move it into
+      // a smaller one, to keep the large slots available
+      void * res = nullptr;
+      if (size <= slots1.slot_size() && !slots1.is_member(ptr))
+        res = slots1.malloc(size);
+      if (!res && size <= slots2.slot_size() && slots3.is_member(ptr))
+        res = slots2.malloc(size);
+      if (!res)
+        return ptr;
+      memcpy(res, ptr, size);
+      bin_free(ptr);
+      return res;
     }
 
     //we need a bigger slot
@@ -78,9 +101,10 @@ void * bin_realloc(void * ptr, size_t size)
         TRACE("libc malloc [%lu] FAILURE", size);  
         return 0;
       }
+      binAllocatorFallbacks++;
     }
     //copy data
-    memcpy(res, ptr, slots1.size(ptr) + slots2.size(ptr));
+    memcpy(res, ptr, slot);
     bin_free(ptr);
     return res;
   }
@@ -120,6 +144,10 @@ void *bin_l_alloc (void *ud, void *ptr, size_t osize, size_t nsize)
       // TRACE("OUR realloc %p[%lu] -> %p[%lu]", ptr, osize, res, nsize); 
     }
     if (res == 0) {
+      if (ptr == nullptr)
+        binAllocatorFallbacks++;
+      else if (bin_size(ptr))
+        return nullptr;  // ours, libc malloc already failed
       res = realloc(ptr, nsize);
       // TRACE("libc realloc %p[%lu] -> %p[%lu]", ptr, osize, res, nsize);
       // if (res == 0 ){
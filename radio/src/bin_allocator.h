@@ -24,28 +24,35 @@
 
 #include "debug.h"
 
+// Fixed size slots allocator: free slots are chained through their first
+// bytes, and slots never used yet are taken in order, so that malloc() and
+// free() are O(1) and nothing has to be initialized upfront. Slots are 8 bytes
+// aligned as Lua stores doubles in them.
 template <int SIZE_SLOT, int NUM_BINS> class BinAllocator {
 private:
-  PACK(struct Bin {
-    char data[SIZE_SLOT];
-    bool Used;
-  });
-  struct Bin Bins[NUM_BINS];
-  int NoUsedBins;
+  union Slot {
+    Slot * next;
+    alignas(8) char data[(SIZE_SLOT + 7) & ~7];
+  };
+  Slot Bins[NUM_BINS];
+  Slot * FreeList;
+  uint16_t NoTouchedBins;  // slots below this index have been used at least once
+  uint16_t NoUsedBins;
+  uint16_t PeakUsedBins;
+  uint32_t NoHits;
 public:
-  BinAllocator() : NoUsedBins(0) {
-    memclear(Bins, sizeof(Bins));
+  BinAllocator() : FreeList(nullptr), NoTouchedBins(0), NoUsedBins(0), PeakUsedBins(0), NoHits(0) {
   }
   bool free(void * ptr) {
-    for (size_t n = 0; n < NUM_BINS; ++n) {
-      if (ptr == Bins[n].data) {
-        Bins[n].Used = false;
-        --NoUsedBins;
-        // TRACE("\tBinAllocator<%d> free %lu ------", SIZE_SLOT, n);
-        return true;
-      }
+    if (!is_member(ptr)) {
+      return false;
     }
-    return false;
+    Slot * slot = &Bins[((char *)ptr - Bins[0].data) / sizeof(Slot)];
+    slot->next = FreeList;
+    FreeList = slot;
+    --NoUsedBins;
+    // TRACE("\tBinAllocator<%d> free %lu ------", SIZE_SLOT, slot - Bins);
+    return true;
   }
   bool is_member(void * ptr) {
     return (ptr >= Bins[0].data && ptr <= Bins[NUM_BINS-1].data);
@@ -55,20 +62,23 @@ public:
       // TRACE("BinAllocator<%d> malloc [%lu] size > SIZE_SLOT", SIZE_SLOT, size);
       return 0;
     }
-    if (NoUsedBins >= NUM_BINS) {
+    Slot * slot = FreeList;
+    if (slot) {
+      FreeList = slot->next;
+    }
+    else if (NoTouchedBins < NUM_BINS) {
+      slot = &Bins[NoTouchedBins++];
+    }
+    else {
       // TRACE("BinAllocator<%d> malloc [%lu] no free slots", SIZE_SLOT, size);
       return 0;
     }
-    for (size_t n = 0; n < NUM_BINS; ++n) {
-      if (!Bins[n].Used) {
-        Bins[n].Used = true;
-        ++NoUsedBins;
-        // TRACE("\tBinAllocator<%d> malloc %lu[%lu]", SIZE_SLOT, n, size);
-        return Bins[n].data;
-      }
+    if (++NoUsedBins > PeakUsedBins) {
+      PeakUsedBins = NoUsedBins;
     }
-    // TRACE("BinAllocator<%d> malloc [%lu] no free slots", SIZE_SLOT , size);
-    return 0;
+    ++NoHits;
+    // TRACE("\tBinAllocator<%d> malloc %lu[%lu]", SIZE_SLOT, slot - Bins, size);
+    return slot->data;
   }
   size_t size(void * ptr) {
     return is_member(ptr) ? SIZE_SLOT : 0;
@@ -78,19 +88,36 @@ public:
   }
   unsigned int capacity() { return NUM_BINS; }
   unsigned int size() { return NoUsedBins; }
+  unsigned int peak() { return PeakUsedBins; }
+  uint32_t hits() { return NoHits; }
+  unsigned int slot_size() { return SIZE_SLOT; }
+  void reset_stats() {
+    PeakUsedBins = NoUsedBins;
+    NoHits = 0;
+  }
 };
 
+// Size classes follow the Lua objects on 32 bits: short strings and
+// closures, then tables, upvalues and longer strings, then prototypes and
+// small node arrays.
 #if defined(SIMU)
-typedef BinAllocator<39,300> BinAllocator_slots1;
-typedef BinAllocator<79,100> BinAllocator_slots2;
+typedef BinAllocator<32,300> BinAllocator_slots1;
+typedef BinAllocator<64,200> BinAllocator_slots2;
+typedef BinAllocator<128,100> BinAllocator_slots3;
 #else
-typedef BinAllocator<27,200> BinAllocator_slots1;
-typedef BinAllocator<91,50> BinAllocator_slots2;
+typedef BinAllocator<24,160> BinAllocator_slots1;
+typedef BinAllocator<40,96> BinAllocator_slots2;
+typedef BinAllocator<96,24> BinAllocator_slots3;
 #endif
 
 #if defined(USE_BIN_ALLOCATOR)
 extern BinAllocator_slots1 slots1;
 extern BinAllocator_slots2 slots2;
+extern BinAllocator_slots3 slots3;
+
+// allocations which did not fit in the slots and went to libc
+extern uint32_t binAllocatorFallbacks;
+void binAllocatorResetStats();
 
 // wrapper for our BinAllocator for Lua
 void *bin_l_alloc (void *ud, void *ptr, size_t osize, size_t nsize);
@@ -29,6 +29,10 @@
 
 #include "cli.h"
 
+#if defined(USE_BIN_ALLOCATOR)
+#include "bin_allocator.h"
+#endif
+
 #include <ctype.h>
 #include <malloc.h>
 #include <new>
@@ -898,6 +902,13 @@ int cliMemoryInfo(const char ** argv)
   cliSerialPrint("------------");
   cliSerialPrint("\tTotal   %u", s + w + e);
 #endif
+#if defined(USE_BIN_ALLOCATOR)
+  cliSerialPrint("\nLua slots (used/peak/capacity hits):");
+  cliSerialPrint("\t%3ub %u/%u/%u %u", slots1.slot_size(), slots1.size(), slots1.peak(), slots1.capacity(), (unsigned)slots1.hits());
+  cliSerialPrint("\t%3ub %u/%u/%u %u", slots2.slot_size(), slots2.size(), slots2.peak(), slots2.capacity(), (unsigned)slots2.hits());
+  cliSerialPrint("\t%3ub %u/%u/%u %u", slots3.slot_size(), slots3.size(), slots3.peak(), slots3.capacity(), (unsigned)slots3.hits());
+  cliSerialPrint("\tlibc %u", (unsigned)binAllocatorFallbacks);
+#endif
 #endif
   return 0;
 }
@@ -1376,11 +1387,18 @@ int cliDisplay(const char ** argv)
     printAudioVars();
   }
 #endif
+  else if (!strcmp(argv[1], "expo")) {
+    uint32_t total = expoCacheStats.hits + expoCacheStats.misses;
+    uint32_t hitRate = total ? (uint64_t)expoCacheStats.hits * 1000 / total : 0;
+    cliSerialPrint("Inputs cache stats: h: %u(%0.1f%%), m: %u", expoCacheStats.hits, hitRate*0.1f, expoCacheStats.misses);
+  }
 #if defined(DISK_CACHE)
   else if (!strcmp(argv[1], "dc")) {
-    DiskCacheStats stats = diskCache.getStats();
-    uint32_t hitRate = diskCache.getHitRate();
+    DiskCacheStats stats = diskCache[0].getStats();
+    uint32_t hitRate = diskCache[0].getHitRate();
     cliSerialPrint("Disk Cache stats: w:%u r: %u, h: %u(%0.1f%%), m: %u", stats.noWrites, (stats.noHits + stats.noMisses), stats.noHits, hitRate*0.1f, stats.noMisses);
+    cliSerialPrint("  protected h: %u, ghost h: %u, read-ahead: %u (h: %u), bypass: %u", stats.noProtectedHits, stats.noGhostHits, stats.noReadAheads, stats.noReadAheadHits, stats.noBypasses);
+    cliSerialPrint("  disk writes: %u", stats.noDiskWrites);
   }
 #endif
   else if (toLongLongInt(argv, 1, &address) > 0) {
@@ -29,10 +29,19 @@ enum {
   CRC_1189,
 };
 
-uint8_t crc8(const uint8_t * ptr, uint32_t len);
-uint8_t crc8_BA(const uint8_t * ptr, uint32_t len);
+// start allows to continue a CRC over several buffers
+uint8_t crc8(const uint8_t * ptr, uint32_t len, uint8_t start = 0);
+uint8_t crc8_BA(const uint8_t * ptr, uint32_t len, uint8_t start = 0);
 uint16_t crc16(uint8_t index, const uint8_t * buf, uint32_t len, uint16_t start = 0);
 
+// Byte by byte update, for parsers computing the CRC as bytes arrive
+extern const unsigned char crc8tab[256];
+
+inline uint8_t crc8_update(uint8_t crc, uint8_t byte)
+{
+  return crc8tab[crc ^ byte];
+}
+
 // CRC16 implementation according to CCITT standards
 static const unsigned short crc16tab_1021[256] = {
   0x0000,0x1021,0x2042,0x3063,0x4084,0x50a5,0x60c6,0x70e7,
@@ -228,6 +228,36 @@ int32_t compute_tangent(CurveHeader* crv, const int8_t* points, int i)
   return m;
 }
 
+static void getCurveSegment(bool custom, const int8_t* points, uint8_t count,
+                            int i, int32_t& p0x, int32_t& p3x)
+{
+  if (custom) {
+    p0x = (i>0 ? calc100toRESX(points[count+i-1]) : -RESX);
+    p3x = (i<count-2 ? calc100toRESX(points[count+i]) : RESX);
+  }
+  else {
+    p0x = -RESX + (i*2*RESX)/(count-1);
+    p3x = -RESX + ((i+1)*2*RESX)/(count-1);
+  }
+}
+
+static int16_t hermiteSegment(int32_t x, int32_t p0x, int32_t p3x,
+                              int32_t p0y, int32_t p3y, int32_t m0, int32_t m3)
+{
+  int32_t y;
+  int32_t h = p3x - p0x;
+  int32_t t = (h > 0 ? (MMULT * (x - p0x)) / h : 0);
+  int32_t t2 = t * t / MMULT;
+  int32_t t3 = t2 * t / MMULT;
+  int32_t h00 = 2*t3 - 3*t2 + MMULT;
+  int32_t h10 = t3 - 2*t2 + t;
+  int32_t h01 = -2*t3 + 3*t2;
+  int32_t h11 = t3 - t2;
+  y = p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT);
+  y /= MMULT;
+  return y;
+}
+
 /* The following is a hermite cubic spline.
    The basis functions can be found here:
    http://en.wikipedia.org/wiki/Cubic_Hermite_spline
@@ -247,32 +277,12 @@ int16_t hermite_spline(int16_t x, uint8_t idx)
 
   for (int i=0; i<count-1; i++) {
     int32_t p0x, p3x;
-    if (custom) {
-      p0x = (i>0 ? calc100toRESX(points[count+i-1]) : -RESX);
-      p3x = (i<count-2 ? calc100toRESX(points[count+i]) : RESX);
-    }
-    else {
-      p0x = -RESX + (i*2*RESX)/(count-1);
-      p3x = -RESX + ((i+1)*2*RESX)/(count-1);
-    }
-
+    getCurveSegment(custom, points, count, i, p0x, p3x);
     if (x >= p0x && x <= p3x) {
-      int32_t p0y = calc100toRESX(points[i]);
-      int32_t p3y = calc100toRESX(points[i+1]);
-      int32_t m0 = compute_tangent(&crv, points, i);
-      int32_t m3 = compute_tangent(&crv, points, i+1);
-      int32_t y;
-      int32_t h = p3x - p0x;
-      int32_t t = (h > 0 ? (MMULT * (x - p0x)) / h : 0);
-      int32_t t2 = t * t / MMULT;
-      int32_t t3 = t2 * t / MMULT;
-      int32_t h00 = 2*t3 - 3*t2 + MMULT;
-      int32_t h10 = t3 - 2*t2 + t;
-      int32_t h01 = -2*t3 + 3*t2;
-      int32_t h11 = t3 - t2;
-      y = p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT);
-      y /= MMULT;
-      return y;
+      return hermiteSegment(x, p0x, p3x,
+                            calc100toRESX(points[i]), calc100toRESX(points[i+1]),
+                            compute_tangent(&crv, points, i),
+                            compute_tangent(&crv, points, i+1));
     }
   }
   return 0;
@@ -316,7 +326,184 @@ int intpol(int x, uint8_t idx) // -100, -75, -50, -25, 0 ,25 ,50, 75, 100
   return erg / 25; // 100*D5/RESX;
 }
 
-int applyCurve(int x, CurveRef & curve)
+// Smooth curves are costly to evaluate: every call searches the segment
+// and recomputes two tangents. The mixer keeps the curves it uses sampled
+// every CURVE_CACHE_STEP and interpolates between samples. Intervals where
+// the interpolation would be off by more than one unit are flagged and
+// still evaluated exactly. Intervals are sampled the first time the curve
+// is looked up inside them, so an edit never costs the mixer a full scan.
+#if defined(COLORLCD)
+  #define CURVE_CACHE_SLOTS    8
+#else
+  #define CURVE_CACHE_SLOTS    4
+#endif
+#define CURVE_CACHE_SHIFT      3
+#define CURVE_CACHE_STEP       (1 << CURVE_CACHE_SHIFT)
+#define CURVE_CACHE_INTERVALS  (2 * RESX / CURVE_CACHE_STEP)
+#define CURVE_CACHE_IDLE       100 // 10ms ticks before a slot may be reused
+#define CURVE_CACHE_UNUSED     0xFF
+
+struct CurveCacheSlot {
+  uint8_t idx;
+  uint32_t revision;
+  tmr10ms_t lastUsed;
+  // copy of the curve the samples were built from
+  CurveHeader header;
+  int8_t points[2 * MAX_POINTS_PER_CURVE - 2];
+  int32_t tangents[MAX_POINTS_PER_CURVE];
+  uint8_t sampled[(CURVE_CACHE_INTERVALS + 1 + 7) / 8];
+  uint8_t checked[CURVE_CACHE_INTERVALS / 8];
+  uint8_t exact[CURVE_CACHE_INTERVALS / 8];
+  int16_t values[CURVE_CACHE_INTERVALS + 1];
+};
+
+static CurveCacheSlot curveCache[CURVE_CACHE_SLOTS];
+static bool curveCacheInitialized = false;
+
+#define CURVE_CACHE_BIT(bits, i)      (bits[(i) / 8] & (1 << ((i) % 8)))
+#define CURVE_CACHE_SET_BIT(bits, i)  (bits[(i) / 8] |= 1 << ((i) % 8))
+
+static int16_t hermiteSample(const CurveCacheSlot& slot, int32_t x)
+{
+  bool custom = (slot.header.type == CURVE_TYPE_CUSTOM);
+  uint8_t count = STD_CURVE_POINTS(slot.header.points);
+
+  for (int i=0; i<count-1; i++) {
+    int32_t p0x, p3x;
+    getCurveSegment(custom, slot.points, count, i, p0x, p3x);
+    if (x >= p0x && x <= p3x) {
+      return hermiteSegment(x, p0x, p3x,
+                            calc100toRESX(slot.points[i]),
+                            calc100toRESX(slot.points[i+1]),
+                            slot.tangents[i], slot.tangents[i+1]);
+    }
+  }
+  return 0;
+}
+
+static inline int16_t curveCacheInterpolate(const CurveCacheSlot& slot,
+                                            unsigned interval, unsigned r)
+{
+  int32_t y0 = slot.values[interval];
+  int32_t y1 = slot.values[interval + 1];
+  return y0 + divRoundClosest((y1 - y0) * (int)r, CURVE_CACHE_STEP);
+}
+
+static bool isCurveCacheSlotValid(const CurveCacheSlot& slot, uint8_t idx)
+{
+  return !memcmp(&slot.header, &g_model.curves[idx], sizeof(CurveHeader)) &&
+         !memcmp(slot.points, curveAddress(idx), getCurvePoints(idx));
+}
+
+static void resetCurveCache(CurveCacheSlot& slot, uint8_t idx)
+{
+  CurveHeader& crv = g_model.curves[idx];
+  int8_t* points = curveAddress(idx);
+
+  slot.header = crv;
+  memclear(slot.points, sizeof(slot.points));
+  memcpy(slot.points, points, getCurvePoints(idx));
+
+  for (int i=0; i<STD_CURVE_POINTS(crv.points); i++) {
+    slot.tangents[i] = compute_tangent(&crv, points, i);
+  }
+
+  memclear(slot.sampled, sizeof(slot.sampled));
+  memclear(slot.checked, sizeof(slot.checked));
+  memclear(slot.exact, sizeof(slot.exact));
+}
+
+static void sampleCurveCache(CurveCacheSlot& slot, unsigned i)
+{
+  if (!CURVE_CACHE_BIT(slot.sampled, i)) {
+    slot.values[i] = hermiteSample(slot, -RESX + i * CURVE_CACHE_STEP);
+    CURVE_CACHE_SET_BIT(slot.sampled, i);
+  }
+}
+
+static void checkCurveCacheInterval(CurveCacheSlot& slot, unsigned interval)
+{
+  if (CURVE_CACHE_BIT(slot.checked, interval))
+    return;
+
+  sampleCurveCache(slot, interval);
+  sampleCurveCache(slot, interval + 1);
+
+  for (int r=1; r<CURVE_CACHE_STEP; r++) {
+    int16_t y = hermiteSample(slot, -RESX + interval * CURVE_CACHE_STEP + r);
+    if (abs(y - curveCacheInterpolate(slot, interval, r)) > 1) {
+      CURVE_CACHE_SET_BIT(slot.exact, interval);
+      break;
+    }
+  }
+
+  CURVE_CACHE_SET_BIT(slot.checked, interval);
+}
+
+static CurveCacheSlot* getCurveCacheSlot(uint8_t idx)
+{
+  if (!curveCacheInitialized) {
+    for (auto& slot: curveCache) slot.idx = CURVE_CACHE_UNUSED;
+    curveCacheInitialized = true;
+  }
+
+  tmr10ms_t now = get_tmr10ms();
+  CurveCacheSlot* victim = nullptr;
+
+  for (auto& slot: curveCache) {
+    if (slot.idx == idx) {
+      if (slot.revision != modelDataRevision) {
+        slot.revision = modelDataRevision;
+        if (!isCurveCacheSlotValid(slot, idx)) resetCurveCache(slot, idx);
+      }
+      slot.lastUsed = now;
+      return &slot;
+    }
+    if (slot.idx == CURVE_CACHE_UNUSED) {
+      if (!victim || victim->idx != CURVE_CACHE_UNUSED) victim = &slot;
+    }
+    else if (!victim && (tmr10ms_t)(now - slot.lastUsed) > CURVE_CACHE_IDLE) {
+      victim = &slot;
+    }
+  }
+
+  // all slots busy: don't thrash, evaluate exactly instead
+  if (!victim) return nullptr;
+
+  victim->idx = idx;
+  victim->revision = modelDataRevision;
+  victim->lastUsed = now;
+  resetCurveCache(*victim, idx);
+  return victim;
+}
+
+int applyCachedCurve(int x, uint8_t idx)
+{
+  if (idx >= MAX_CURVES)
+    return 0;
+
+  if (!g_model.curves[idx].smooth)
+    return intpol(x, idx);
+
+  CurveCacheSlot* slot = getCurveCacheSlot(idx);
+  if (!slot)
+    return hermite_spline(x, idx);
+
+  unsigned pos = limit<int>(-RESX, x, RESX) + RESX;
+  unsigned interval = pos >> CURVE_CACHE_SHIFT;
+  unsigned r = pos & (CURVE_CACHE_STEP - 1);
+
+  if (r == 0) {
+    sampleCurveCache(*slot, interval);
+    return slot->values[interval];
+  }
+  checkCurveCacheInterval(*slot, interval);
+  if (CURVE_CACHE_BIT(slot->exact, interval))
+    return hermite_spline(x, idx);
+  return curveCacheInterpolate(*slot, interval, r);
+}
+
+int applyCurve(int x, CurveRef & curve, bool cached)
 {
   switch (curve.type) {
     case CURVE_REF_DIFF:
@@ -362,7 +549,8 @@ int applyCurve(int x, CurveRef & curve)
         curveParam = -curveParam;
       }
       if (curveParam > 0 && curveParam <= MAX_CURVES) {
-        return applyCustomCurve(x, curveParam - 1);
+        return cached ? applyCachedCurve(x, curveParam - 1)
+                      : applyCustomCurve(x, curveParam - 1);
       }
       break;
     }
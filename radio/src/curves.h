@@ -44,7 +44,9 @@ void resetCustomCurveX(int8_t * points, int noPoints);
 point_t getPoint(uint8_t i);
 point_t getPoint(uint8_t curveIndex, uint8_t index);
 int applyCustomCurve(int x, uint8_t idx);
-int applyCurve(int x, CurveRef & curve);
+// cached variants are for the mixer task, or with the mixer paused
+int applyCachedCurve(int x, uint8_t idx);
+int applyCurve(int x, CurveRef & curve, bool cached = false);
 int applyCurrentCurve(int x);
 
 char *getCurveRefString(char *dest, size_t len, const CurveRef& curve);
@@ -19,10 +19,13 @@
  * GNU General Public License for more details.
  */
 
+#include <assert.h>
 #include <string.h>
+#include <new>
 #include "opentx.h"
 
-#if defined(SIMU) && !defined(SIMU_DISKIO)
+// unit tests provide their own RAM disk
+#if defined(SIMU) && !defined(SIMU_DISKIO) && !defined(GTESTS)
   #define __disk_read(...)    (RES_OK)
   #define __disk_write(...)   (RES_OK)
 #endif
@@ -35,9 +38,21 @@
 
 DiskCache diskCache[2];
 
+#define DISK_CACHE_NONE   (-1)
+
+static inline DWORD blockOf(DWORD sector)
+{
+  return sector / DISK_CACHE_BLOCK_SECTORS;
+}
+
 DiskCacheBlock::DiskCacheBlock():
   startSector(0),
-  endSector(0) 
+  endSector(0),
+  prev(DISK_CACHE_NONE),
+  next(DISK_CACHE_NONE),
+  hashNext(DISK_CACHE_NONE),
+  queue(DISK_CACHE_FREE),
+  readAhead(false)
 {
 }
 
@@ -51,7 +66,7 @@ bool DiskCacheBlock::read(BYTE * buff, DWORD sector, UINT count)
   return false;
 }
 
-DRESULT DiskCacheBlock::fill(BYTE drv, BYTE * buff, DWORD sector, UINT count)
+DRESULT DiskCacheBlock::fill(BYTE drv, DWORD sector)
 {
   DRESULT res = __disk_read(drv, data, sector, DISK_CACHE_BLOCK_SECTORS);
   if (res != RES_OK) {
@@ -59,19 +74,10 @@ DRESULT DiskCacheBlock::fill(BYTE drv, BYTE * buff, DWORD sector, UINT count)
   }
   startSector = sector;
   endSector = sector + DISK_CACHE_BLOCK_SECTORS;
-  memcpy(buff, data, count * BLOCK_SIZE);
-  TRACE_DISK_CACHE("\tcache %p FILLED from read(%u, %u)", this, (uint32_t)sector, (uint32_t)count);
+  TRACE_DISK_CACHE("\tcache %p FILLED from %u", this, (uint32_t)sector);
   return RES_OK;
 }
 
-void DiskCacheBlock::free(DWORD sector, UINT count) 
-{
-  if (sector < endSector && (sector+count) > startSector) {
-    TRACE_DISK_CACHE("\tINVALIDATING disk cache block %p (%u)", this, startSector);
-    endSector = 0;
-  }
-}
-
 void DiskCacheBlock::free()
 {
   endSector = 0;
@@ -83,83 +89,406 @@ bool DiskCacheBlock::empty() const
 }
 
 DiskCache::DiskCache():
-  lastBlock(0)
+  pending(nullptr),
+  pendingCount(0),
+  writeBack(false)
 {
-  stats.noHits = 0;
-  stats.noMisses = 0;
-  stats.noWrites = 0;
   blocks = new DiskCacheBlock[DISK_CACHE_BLOCKS_NUM];
+  clear();
+}
+
+void DiskCache::resetStats()
+{
+  memset(&stats, 0, sizeof(stats));
 }
 
 void DiskCache::clear()
 {
+  resetStats();
   lastBlock = 0;
-  stats.noHits = 0;
-  stats.noMisses = 0;
-  stats.noWrites = 0;
-  for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
+  lastGhost = 0;
+  // pending writes must have been flushed (setWriteBack(drv, false)) before
+  // the card is unmounted: they can't go to the card mounted next
+  assert(pendingCount == 0);
+  pendingError = RES_OK;
+  memset(ghosts, 0xFF, sizeof(ghosts));
+  memset(hash, DISK_CACHE_NONE, sizeof(hash));
+  for (int q=0; q<DISK_CACHE_QUEUES; q++) {
+    heads[q] = tails[q] = DISK_CACHE_NONE;
+    counts[q] = 0;
+  }
+  for (int n=DISK_CACHE_BLOCKS_NUM-1; n>=0; --n) {
     blocks[n].free();
+    blocks[n].hashNext = DISK_CACHE_NONE;
+    blocks[n].readAhead = false;
+    pushFront(n, DISK_CACHE_FREE);
+  }
+}
+
+void DiskCache::unlink(int index)
+{
+  DiskCacheBlock & block = blocks[index];
+  if (block.prev != DISK_CACHE_NONE)
+    blocks[block.prev].next = block.next;
+  else
+    heads[block.queue] = block.next;
+  if (block.next != DISK_CACHE_NONE)
+    blocks[block.next].prev = block.prev;
+  else
+    tails[block.queue] = block.prev;
+  counts[block.queue]--;
+}
+
+void DiskCache::pushFront(int index, uint8_t queue)
+{
+  DiskCacheBlock & block = blocks[index];
+  block.queue = queue;
+  block.prev = DISK_CACHE_NONE;
+  block.next = heads[queue];
+  if (heads[queue] != DISK_CACHE_NONE)
+    blocks[heads[queue]].prev = index;
+  else
+    tails[queue] = index;
+  heads[queue] = index;
+  counts[queue]++;
+}
+
+void DiskCache::hashInsert(int index)
+{
+  int8_t & head = hash[blockOf(blocks[index].startSector) & (DISK_CACHE_HASH_SIZE - 1)];
+  blocks[index].hashNext = head;
+  head = index;
+}
+
+void DiskCache::hashRemove(int index)
+{
+  int8_t * link = &hash[blockOf(blocks[index].startSector) & (DISK_CACHE_HASH_SIZE - 1)];
+  while (*link != DISK_CACHE_NONE) {
+    if (*link == index) {
+      *link = blocks[index].hashNext;
+      break;
+    }
+    link = &blocks[*link].hashNext;
+  }
+  blocks[index].hashNext = DISK_CACHE_NONE;
+}
+
+int DiskCache::findBlock(DWORD block) const
+{
+  for (int8_t n = hash[block & (DISK_CACHE_HASH_SIZE - 1)]; n != DISK_CACHE_NONE; n = blocks[n].hashNext) {
+    if (!blocks[n].empty() && blockOf(blocks[n].startSector) == block) {
+      return n;
+    }
+  }
+  return DISK_CACHE_NONE;
+}
+
+void DiskCache::invalidateBlock(int index)
+{
+  hashRemove(index);
+  unlink(index);
+  blocks[index].free();
+  blocks[index].readAhead = false;
+  pushFront(index, DISK_CACHE_FREE);
+}
+
+bool DiskCache::takeGhost(DWORD block)
+{
+  for (int n=0; n<DISK_CACHE_GHOSTS_NUM; n++) {
+    if (ghosts[n] == block) {
+      ghosts[n] = (DWORD)-1;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns a free block, evicting one if needed
+int DiskCache::evictBlock()
+{
+  int index = tails[DISK_CACHE_FREE];
+  if (index != DISK_CACHE_NONE) {
+    unlink(index);
+    return index;
+  }
+
+  if (counts[DISK_CACHE_PROBATION] > DISK_CACHE_PROBATION_MAX ||
+      counts[DISK_CACHE_PROTECTED] == 0) {
+    index = tails[DISK_CACHE_PROBATION];
+    // remember it: if it is read again soon, it deserves protection
+    ghosts[lastGhost] = blockOf(blocks[index].startSector);
+    lastGhost = (lastGhost + 1) % DISK_CACHE_GHOSTS_NUM;
+  }
+  else {
+    index = tails[DISK_CACHE_PROTECTED];
+  }
+
+  TRACE_DISK_CACHE("\t\t evicting block %d from queue %d", index, blocks[index].queue);
+  hashRemove(index);
+  unlink(index);
+  blocks[index].free();
+  return index;
+}
+
+int DiskCache::fillBlock(BYTE drv, DWORD block, bool readAhead, DRESULT& res)
+{
+  int index = evictBlock();
+  res = blocks[index].fill(drv, block * DISK_CACHE_BLOCK_SECTORS);
+  if (res != RES_OK) {
+    pushFront(index, DISK_CACHE_FREE);
+    return DISK_CACHE_NONE;
+  }
+  readPending(blocks[index].data, blocks[index].startSector, DISK_CACHE_BLOCK_SECTORS);
+
+  blocks[index].readAhead = readAhead;
+  hashInsert(index);
+  if (takeGhost(block)) {
+    ++stats.noGhostHits;
+    pushFront(index, DISK_CACHE_PROTECTED);
+  }
+  else {
+    pushFront(index, DISK_CACHE_PROBATION);
+  }
+  return index;
+}
+
+DRESULT DiskCache::readBlock(BYTE drv, BYTE * buff, DWORD sector, UINT count, DWORD sectors)
+{
+  DWORD block = blockOf(sector);
+  bool sequential = (block == lastBlock + 1);
+  lastBlock = block;
+
+  int index = findBlock(block);
+  if (index != DISK_CACHE_NONE) {
+    DiskCacheBlock & cached = blocks[index];
+    cached.read(buff, sector, count);
+    ++stats.noHits;
+    if (cached.readAhead) {
+      cached.readAhead = false;
+      ++stats.noReadAheadHits;
+    }
+    // hits in probation are considered correlated and don't move the block
+    if (cached.queue == DISK_CACHE_PROTECTED) {
+      ++stats.noProtectedHits;
+      unlink(index);
+      pushFront(index, DISK_CACHE_PROTECTED);
+    }
+    return RES_OK;
+  }
+
+  ++stats.noMisses;
+
+  DRESULT res;
+  index = fillBlock(drv, block, false, res);
+  if (index == DISK_CACHE_NONE) {
+    return res;
+  }
+  blocks[index].read(buff, sector, count);
+
+  // sequential access: fetch the next block as well
+  if (sequential && (block + 2) * DISK_CACHE_BLOCK_SECTORS <= sectors &&
+      findBlock(block + 1) == DISK_CACHE_NONE) {
+    TRACE_DISK_CACHE("\t\t read-ahead block %u", (uint32_t)(block + 1));
+    ++stats.noReadAheads;
+    fillBlock(drv, block + 1, true, res);
+  }
+
+  return RES_OK;
+}
+
+void DiskCache::invalidateBlocks(DWORD sector, UINT count)
+{
+  DWORD first = blockOf(sector);
+  DWORD last = blockOf(sector + count - 1);
+  if (last - first < DISK_CACHE_BLOCKS_NUM) {
+    for (DWORD block = first; block <= last; block++) {
+      int index = findBlock(block);
+      if (index != DISK_CACHE_NONE) {
+        invalidateBlock(index);
+      }
+    }
+  }
+  else {
+    for (int n=0; n < DISK_CACHE_BLOCKS_NUM; ++n) {
+      if (!blocks[n].empty() && blocks[n].startSector < sector + count &&
+          blocks[n].endSector > sector) {
+        invalidateBlock(n);
+      }
+    }
+  }
+}
+
+// Copies written sectors into the cached blocks holding them
+void DiskCache::updateBlocks(const BYTE * buff, DWORD sector, UINT count)
+{
+  DWORD first = blockOf(sector);
+  DWORD last = blockOf(sector + count - 1);
+  if (last - first >= DISK_CACHE_BLOCKS_NUM) {
+    invalidateBlocks(sector, count);
+    return;
+  }
+  for (DWORD block = first; block <= last; block++) {
+    int index = findBlock(block);
+    if (index != DISK_CACHE_NONE) {
+      DiskCacheBlock & cached = blocks[index];
+      DWORD start = max<DWORD>(sector, cached.startSector);
+      DWORD end = min<DWORD>(sector + count, cached.endSector);
+      memcpy(cached.data + (start - cached.startSector) * BLOCK_SIZE,
+             buff + (start - sector) * BLOCK_SIZE, (end - start) * BLOCK_SIZE);
+    }
+  }
+}
+
+// Overlays the pending sectors on data just read from the disk
+void DiskCache::readPending(BYTE * buff, DWORD sector, UINT count) const
+{
+  if (pendingCount == 0 || sector >= pendingSector + pendingCount ||
+      sector + count <= pendingSector) {
+    return;
+  }
+  DWORD start = max<DWORD>(sector, pendingSector);
+  DWORD end = min<DWORD>(sector + count, pendingSector + pendingCount);
+  memcpy(buff + (start - sector) * BLOCK_SIZE,
+         pending + (start - pendingSector) * BLOCK_SIZE, (end - start) * BLOCK_SIZE);
+}
+
+DRESULT DiskCache::diskRead(BYTE drv, BYTE * buff, DWORD sector, UINT count)
+{
+  DRESULT res = __disk_read(drv, buff, sector, count);
+  if (res == RES_OK) {
+    readPending(buff, sector, count);
   }
+  return res;
+}
+
+DRESULT DiskCache::diskWrite(BYTE drv, const BYTE * buff, DWORD sector, UINT count)
+{
+  ++stats.noDiskWrites;
+  DRESULT res = __disk_write(drv, buff, sector, count);
+  if (res != RES_OK) {
+    // what is on the disk is unknown now
+    invalidateBlocks(sector, count);
+  }
+  return res;
+}
+
+DRESULT DiskCache::writePending(BYTE drv)
+{
+  if (pendingCount == 0) {
+    return RES_OK;
+  }
+  TRACE_DISK_CACHE("\t\t flush(%u, %u)", (uint32_t)pendingSector, (uint32_t)pendingCount);
+  UINT count = pendingCount;
+  pendingCount = 0;
+  return diskWrite(drv, pending, pendingSector, count);
+}
+
+DRESULT DiskCache::flush(BYTE drv)
+{
+  DRESULT res = writePending(drv);
+  if (pendingError != RES_OK) {
+    res = pendingError;
+    pendingError = RES_OK;
+  }
+  return res;
+}
+
+void DiskCache::checkTimeout(BYTE drv)
+{
+  if (pendingCount > 0 && get_tmr10ms() - pendingTime >= DISK_CACHE_WRITE_TIMEOUT) {
+    DRESULT res = writePending(drv);
+    if (res != RES_OK) {
+      pendingError = res;
+    }
+  }
+}
+
+void DiskCache::setWriteBack(BYTE drv, bool enable)
+{
+  if (enable && !pending) {
+    pending = new (std::nothrow) BYTE[DISK_CACHE_WRITE_SECTORS * BLOCK_SIZE];
+    if (!pending) {
+      TRACE("DiskCache: no memory for write-back, writing through");
+      enable = false;
+    }
+  }
+  else if (!enable) {
+    flush(drv);
+  }
+  writeBack = enable;
 }
 
 DRESULT DiskCache::read(BYTE drv, BYTE * buff, DWORD sector, UINT count)
 {
-  // TODO: check if not caching first sectors would improve anything
-  // if (sector < 1000) {
-  //   ++stats.noMisses;
-  //   return __disk_read(drv, buff, sector, count);  
-  // }
+  checkTimeout(drv);
 
   // if read is bigger than cache block, then read it directly without using cache
   if (count > DISK_CACHE_BLOCK_SECTORS) {
     TRACE_DISK_CACHE("\t\t big read(%u, %u)",  (uint32_t)sector, (uint32_t)count);
-    return __disk_read(drv, buff, sector, count);
+    ++stats.noBypasses;
+    return diskRead(drv, buff, sector, count);
   }
   
   // if block + cache block size is beyond the end of the disk, then read it directly without using cache
-  size_t sectors = 0;
+  DWORD sectors = 0;
   DRESULT res = RES_OK;
-#if !defined(SIMU)
+#if !defined(SIMU) || defined(GTESTS)
   res = disk_ioctl(drv, GET_SECTOR_COUNT, &sectors);
 #endif
-  if (res != RES_OK || sector+DISK_CACHE_BLOCK_SECTORS >= sectors) {
-    TRACE_DISK_CACHE("\t\t cache would be beyond end of disk %u (%u)", (uint32_t)sector, sdGetNoSectors());
-    return __disk_read(drv, buff, sector, count);
+  DWORD last = blockOf(sector + count - 1);
+  if (res != RES_OK || (last + 1) * DISK_CACHE_BLOCK_SECTORS > sectors) {
+    TRACE_DISK_CACHE("\t\t cache would be beyond end of disk %u (%u)", (uint32_t)sector, (uint32_t)sectors);
+    ++stats.noBypasses;
+    return diskRead(drv, buff, sector, count);
   }
 
-  for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
-    if (blocks[n].read(buff, sector, count)) {
-      ++stats.noHits;
-      return RES_OK;
+  // blocks are aligned: a read may span two of them
+  if (blockOf(sector) != last) {
+    UINT first = last * DISK_CACHE_BLOCK_SECTORS - sector;
+    res = readBlock(drv, buff, sector, first, sectors);
+    if (res != RES_OK) {
+      return res;
     }
+    buff += first * BLOCK_SIZE;
+    sector += first;
+    count -= first;
   }
 
-  ++stats.noMisses;
-
-  // find free block
-  for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
-    if (blocks[n].empty()) {
-      TRACE_DISK_CACHE("\t\t using free block");
-      return blocks[n].fill(drv, buff, sector, count);
-    }
-  }
-
-  // use next block (round robin)
-  // TODO: use better strategy to select which used block gets used here
-  if (++lastBlock >= DISK_CACHE_BLOCKS_NUM) {
-    lastBlock = 0;
-  }
-  
-  return blocks[lastBlock].fill(drv, buff, sector, count);
+  return readBlock(drv, buff, sector, count, sectors);
 }
 
 DRESULT DiskCache::write(BYTE drv, const BYTE* buff, DWORD sector, UINT count)
 {
   ++stats.noWrites;
-  for(int n=0; n < DISK_CACHE_BLOCKS_NUM; ++n) {
-    blocks[n].free(sector, count);
+  if (!writeBack) {
+    invalidateBlocks(sector, count);
+    return diskWrite(drv, buff, sector, count);
+  }
+
+  checkTimeout(drv);
+
+  // the pending window grows as long as writes overlap it or follow it
+  if (pendingCount > 0 && (sector < pendingSector || sector > pendingSector + pendingCount ||
+                           sector + count > pendingSector + DISK_CACHE_WRITE_SECTORS)) {
+    DRESULT res = flush(drv);
+    if (res != RES_OK) {
+      return res;
+    }
+  }
+
+  updateBlocks(buff, sector, count);
+
+  if (pendingCount == 0) {
+    if (count >= DISK_CACHE_WRITE_SECTORS) {
+      return diskWrite(drv, buff, sector, count);
+    }
+    pendingSector = sector;
+    pendingTime = get_tmr10ms();
   }
-  return __disk_write(drv, buff, sector, count);  
+
+  memcpy(pending + (sector - pendingSector) * BLOCK_SIZE, buff, count * BLOCK_SIZE);
+  pendingCount = max<UINT>(pendingCount, sector + count - pendingSector);
+  return RES_OK;
 }
 
 const DiskCacheStats & DiskCache::getStats() const 
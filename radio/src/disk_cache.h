@@ -28,16 +28,33 @@
 // tunable parameters
 #define DISK_CACHE_BLOCKS_NUM      32   // no cache blocks
 #define DISK_CACHE_BLOCK_SECTORS   16   // no sectors
+#define DISK_CACHE_PROBATION_MAX   (DISK_CACHE_BLOCKS_NUM / 4)
+#define DISK_CACHE_GHOSTS_NUM      (DISK_CACHE_BLOCKS_NUM / 2)
+#define DISK_CACHE_HASH_SIZE       64   // power of 2
+#define DISK_CACHE_WRITE_SECTORS   32   // write-back buffer size, in sectors
+#define DISK_CACHE_WRITE_TIMEOUT   100  // 10ms ticks before pending writes are flushed
 
 #define DISK_CACHE_BLOCK_SIZE   (DISK_CACHE_BLOCK_SECTORS * BLOCK_SIZE)
 
+// Blocks are managed the 2Q way: a newly read block enters the probation
+// queue (FIFO) and is only kept in the protected queue (LRU) if it is read
+// again after having been evicted from probation. Streamed data (sounds,
+// logs) therefore can't push FAT and directory sectors out of the cache.
+enum DiskCacheQueue {
+  DISK_CACHE_FREE,
+  DISK_CACHE_PROBATION,
+  DISK_CACHE_PROTECTED,
+  DISK_CACHE_QUEUES
+};
+
 class DiskCacheBlock
 {
+  friend class DiskCache;
+
 public:
   DiskCacheBlock();
   bool read(BYTE* buff, DWORD sector, UINT count);
-  DRESULT fill(BYTE drv, BYTE* buff, DWORD sector, UINT count);
-  void free(DWORD sector, UINT count);
+  DRESULT fill(BYTE drv, DWORD sector);
   void free();
   bool empty() const;
 
@@ -45,6 +62,11 @@ private:
   uint8_t data[DISK_CACHE_BLOCK_SIZE];
   DWORD startSector;
   DWORD endSector;
+  int8_t prev;
+  int8_t next;
+  int8_t hashNext;
+  uint8_t queue;
+  bool readAhead;
 };
 
 struct DiskCacheStats
@@ -52,8 +74,22 @@ struct DiskCacheStats
   uint32_t noHits;
   uint32_t noMisses;
   uint32_t noWrites;
+  uint32_t noProtectedHits;   // hits in the protected queue
+  uint32_t noGhostHits;       // misses on a block recently evicted from probation
+  uint32_t noReadAheads;
+  uint32_t noReadAheadHits;
+  uint32_t noBypasses;        // reads not going through the cache
+  uint32_t noDiskWrites;      // write transfers actually sent to the disk
 };
 
+// When write-back is enabled, writes update the cached blocks in place and
+// are collected in a buffer as long as they hit the same window of adjacent
+// sectors. The buffer is sent to the disk in one transfer when a write falls
+// outside of it, on flush() (CTRL_SYNC, i.e. f_sync() / f_close()), or once
+// the oldest pending write is older than DISK_CACHE_WRITE_TIMEOUT. The
+// timeout is checked on each access and periodically by
+// diskCacheCheckTimeout(), so pending writes don't wait for the next access.
+
 class DiskCache
 {
   public:
@@ -62,14 +98,60 @@ class DiskCache
     DRESULT write(BYTE drv, const BYTE* buff, DWORD sector, UINT count);
     const DiskCacheStats & getStats() const;
     int getHitRate() const;
+    void resetStats();
     void clear();
+    void setWriteBack(BYTE drv, bool enable);
+    DRESULT flush(BYTE drv);
+    void checkTimeout(BYTE drv);
 
   private:
     DiskCacheStats stats;
-    uint32_t lastBlock;
+    DWORD lastBlock;            // last block read, to detect sequential reads
     DiskCacheBlock * blocks;
+    int8_t heads[DISK_CACHE_QUEUES];
+    int8_t tails[DISK_CACHE_QUEUES];
+    uint8_t counts[DISK_CACHE_QUEUES];
+    int8_t hash[DISK_CACHE_HASH_SIZE];
+    DWORD ghosts[DISK_CACHE_GHOSTS_NUM];
+    uint8_t lastGhost;
+    BYTE * pending;             // write-back buffer, allocated on first use
+    DWORD pendingSector;
+    UINT pendingCount;
+    uint32_t pendingTime;
+    DRESULT pendingError;       // failed timed out flush, reported by the next flush()
+    bool writeBack;
+
+    DRESULT readBlock(BYTE drv, BYTE* buff, DWORD sector, UINT count, DWORD sectors);
+    int fillBlock(BYTE drv, DWORD block, bool readAhead, DRESULT& res);
+    int findBlock(DWORD block) const;
+    int evictBlock();
+    void invalidateBlock(int index);
+    void pushFront(int index, uint8_t queue);
+    void unlink(int index);
+    void hashInsert(int index);
+    void hashRemove(int index);
+    bool takeGhost(DWORD block);
+    void invalidateBlocks(DWORD sector, UINT count);
+    void updateBlocks(const BYTE* buff, DWORD sector, UINT count);
+    void readPending(BYTE* buff, DWORD sector, UINT count) const;
+    DRESULT diskRead(BYTE drv, BYTE* buff, DWORD sector, UINT count);
+    DRESULT diskWrite(BYTE drv, const BYTE* buff, DWORD sector, UINT count);
+    DRESULT writePending(BYTE drv);
 };
 
 extern DiskCache diskCache[2];
 
+// Flushes the SD card writes pending for longer than the timeout. Provided
+// by the disk driver, as it must hold the FatFs lock.
+void diskCacheCheckTimeout();
+
+// Writes the pending SD card writes and writes through until
+// diskCacheResume(): before the radio is switched off, or when USB mass
+// storage takes the card over.
+void diskCacheSuspend();
+
+// Drops the cached sectors, which the USB host may have changed, and
+// enables write-back again.
+void diskCacheResume();
+
 #endif // _DISK_CACHE_H_
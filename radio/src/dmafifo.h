@@ -22,6 +22,7 @@
 #ifndef _DMA_FIFO_H_
 #define _DMA_FIFO_H_
 
+#include <string.h>
 #include "definitions.h"
 
 template <int N>
@@ -69,6 +70,24 @@ class DMAFifo
       }
     }
 
+    // Pops up to count bytes, returns the number of bytes popped
+    uint32_t pop(uint8_t * elements, uint32_t count)
+    {
+      if (isEmpty()) {
+        return 0;
+      }
+      uint32_t w = N - stream->NDTR;
+      uint32_t done = 0;
+      while (done < count && ridx != w) {
+        uint32_t n = (w > ridx ? w : N) - ridx;
+        if (n > count - done) n = count - done;
+        memcpy(elements + done, &fifo[ridx], n);
+        ridx = (ridx + n) & (N - 1);
+        done += n;
+      }
+      return done;
+    }
+
     uint8_t * buffer()
     {
       return fifo;
@@ -23,6 +23,12 @@
 #define _FIFO_H_
 
 #include <inttypes.h>
+#include <string.h>
+#include <atomic>
+
+// Single producer / single consumer FIFO (typically an ISR and a task):
+// the data is always written before the index which publishes it, and read
+// before the index which releases it.
 
 template <class T, int N>
 class Fifo
@@ -46,27 +52,106 @@ class Fifo
       uint32_t next = nextIndex(widx);
       if (next != ridx) {
         fifo[widx] = element;
+        std::atomic_signal_fence(std::memory_order_release);
         widx = next;
       }
     }
 
+    // Pushes as many elements as there is space for, returns that count
+    uint32_t push(const T * elements, uint32_t count)
+    {
+      uint32_t w = widx;
+      uint32_t space = (N - 1) - ((N + w - ridx) & (N - 1));
+      if (count > space) count = space;
+      uint32_t first = N - w;
+      if (first > count) first = count;
+      memcpy(&fifo[w], elements, first * sizeof(T));
+      memcpy(&fifo[0], elements + first, (count - first) * sizeof(T));
+      std::atomic_signal_fence(std::memory_order_release);
+      widx = (w + count) & (N - 1);
+      return count;
+    }
+
+    // Contiguous free space starting at the write index, to be filled by
+    // the producer and then published with commit()
+    uint32_t writeSpan(T * & elements)
+    {
+      uint32_t w = widx;
+      uint32_t r = ridx;
+      elements = &fifo[w];
+      if (r > w) return r - w - 1;
+      return N - w - (r == 0 ? 1 : 0);
+    }
+
+    void commit(uint32_t count)
+    {
+      std::atomic_signal_fence(std::memory_order_release);
+      widx = (widx + count) & (N - 1);
+    }
+
     void skip()
     {
       ridx = nextIndex(ridx);
     }
 
+    void skip(uint32_t count)
+    {
+      std::atomic_signal_fence(std::memory_order_release);
+      ridx = (ridx + count) & (N - 1);
+    }
+
     bool pop(T & element)
     {
       if (isEmpty()) {
         return false;
       }
       else {
+        std::atomic_signal_fence(std::memory_order_acquire);
         element = fifo[ridx];
+        std::atomic_signal_fence(std::memory_order_release);
         ridx = nextIndex(ridx);
         return true;
       }
     }
 
+    // Pops up to count elements, returns the number of elements popped
+    uint32_t pop(T * elements, uint32_t count)
+    {
+      T * span;
+      uint32_t done = 0;
+      while (done < count) {
+        uint32_t n = readSpan(span);
+        if (n == 0) break;
+        if (n > count - done) n = count - done;
+        memcpy(elements + done, span, n * sizeof(T));
+        skip(n);
+        done += n;
+      }
+      return done;
+    }
+
+    // Contiguous readable elements starting at the read index, to be
+    // released with skip() once processed
+    uint32_t readSpan(T * & elements)
+    {
+      uint32_t r = ridx;
+      uint32_t w = widx;
+      std::atomic_signal_fence(std::memory_order_acquire);
+      elements = &fifo[r];
+      return (w >= r ? w : N) - r;
+    }
+
+    // Reads the element at offset from the read index without removing it
+    bool peek(uint32_t offset, T & element) const
+    {
+      if (offset >= size()) {
+        return false;
+      }
+      std::atomic_signal_fence(std::memory_order_acquire);
+      element = fifo[(ridx + offset) & (N - 1)];
+      return true;
+    }
+
     bool isEmpty() const
     {
       return (ridx == widx);
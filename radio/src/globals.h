@@ -98,5 +98,6 @@ extern uint8_t beepAgain;
 extern uint16_t lightOffCounter;
 extern uint8_t flashCounter;
 extern uint8_t mixWarning;
+extern bitfield_channels_t mixerLoopChannels; // channels using each other as source
 
 #endif
@@ -21,6 +21,10 @@
 
 #include "opentx.h"
 
+#if defined(USE_BIN_ALLOCATOR)
+#include "bin_allocator.h"
+#endif
+
 #define STATS_1ST_COLUMN               1
 #define STATS_2ND_COLUMN               7*FW+FW/2
 #define STATS_3RD_COLUMN               14*FW+FW/2
@@ -130,6 +134,7 @@ void menuStatisticsDebug(event_t event)
 #if defined(LUA)
       maxLuaInterval = 0;
       maxLuaDuration = 0;
+      maxLuaGcDuration = 0;
 #endif
       maxMixerDuration  = 0;
       break;
@@ -195,6 +200,11 @@ void menuStatisticsDebug(event_t event)
   lcdDrawText(lcdLastRightPos+2, y+1, "[I]", SMLSIZE);
   lcdDrawNumber(lcdLastRightPos, y, 10*maxLuaInterval, LEFT);
   y += FH;
+
+  lcdDrawTextAlignedLeft(y, "Lua GC");
+  lcdDrawNumber(MENU_DEBUG_COL1_OFS, y, maxLuaGcDuration, LEFT);
+  lcdDrawText(lcdLastRightPos, y, "us");
+  y += FH;
 #endif
 
   lcdDrawTextAlignedLeft(y, STR_TMIXMAXMS);
@@ -223,6 +233,21 @@ void menuStatisticsDebug(event_t event)
   lcdInvertLastLine();
 }
 
+#if defined(USE_BIN_ALLOCATOR)
+template <class T>
+static void drawBinAllocatorStats(coord_t y, T & slots)
+{
+  lcdDrawTextAlignedLeft(y, "Lua");
+  lcdDrawNumber(lcdLastRightPos+FW/2, y, slots.slot_size(), LEFT);
+  lcdDrawChar(lcdLastRightPos, y, 'b');
+  lcdDrawNumber(MENU_DEBUG_COL1_OFS, y, slots.size(), RIGHT);
+  lcdDrawChar(lcdLastRightPos, y, '/');
+  lcdDrawNumber(lcdLastRightPos, y, slots.peak(), LEFT);
+  lcdDrawChar(lcdLastRightPos, y, '/');
+  lcdDrawNumber(lcdLastRightPos, y, slots.capacity(), LEFT);
+}
+#endif
+
 void menuStatisticsDebug2(event_t event)
 {
   title(STR_MENUDEBUG);
@@ -230,6 +255,9 @@ void menuStatisticsDebug2(event_t event)
   switch(event) {
     case EVT_KEY_FIRST(KEY_ENTER):
       telemetryErrors  = 0;
+#if defined(USE_BIN_ALLOCATOR)
+      binAllocatorResetStats();
+#endif
       break;
 
     case EVT_KEY_FIRST(KEY_UP):
@@ -268,6 +296,19 @@ void menuStatisticsDebug2(event_t event)
   y += FH;
 #endif
 
+#if defined(USE_BIN_ALLOCATOR)
+  // Lua allocator: used / peak / capacity of each slot size
+  drawBinAllocatorStats(y, slots1);
+  y += FH;
+  drawBinAllocatorStats(y, slots2);
+  y += FH;
+  drawBinAllocatorStats(y, slots3);
+  y += FH;
+  lcdDrawTextAlignedLeft(y, "Lua libc");
+  lcdDrawNumber(MENU_DEBUG_COL1_OFS, y, binAllocatorFallbacks, RIGHT);
+  y += FH;
+#endif
+
   lcdDrawText(LCD_W/2, 7*FH+1, STR_MENUTORESET, CENTERED);
   lcdInvertLastLine();
 }
@@ -21,6 +21,10 @@
 
 #include "opentx.h"
 
+#if defined(USE_BIN_ALLOCATOR)
+#include "bin_allocator.h"
+#endif
+
 #define STATS_1ST_COLUMN               FW/2
 #define STATS_2ND_COLUMN               12*FW+FW/2
 #define STATS_3RD_COLUMN               24*FW+FW/2
@@ -128,6 +132,7 @@ void menuStatisticsDebug(event_t event)
 #if defined(LUA)
       maxLuaInterval = 0;
       maxLuaDuration = 0;
+      maxLuaGcDuration = 0;
 #endif
       maxMixerDuration  = 0;
       break;
@@ -177,6 +182,11 @@ void menuStatisticsDebug(event_t event)
   lcdDrawText(lcdLastRightPos+2, y+1, "[Interval]", SMLSIZE);
   lcdDrawNumber(lcdLastRightPos, y, 10*maxLuaInterval, LEFT);
   y += FH;
+
+  lcdDrawTextAlignedLeft(y, "Lua GC");
+  lcdDrawNumber(MENU_DEBUG_COL1_OFS, y, maxLuaGcDuration, LEFT);
+  lcdDrawText(lcdLastRightPos, y, "us");
+  y += FH;
 #endif
 
   lcdDrawTextAlignedLeft(y, STR_TMIXMAXMS);
@@ -208,6 +218,23 @@ void menuStatisticsDebug(event_t event)
   lcdInvertLastLine();
 }
 
+#if defined(USE_BIN_ALLOCATOR)
+template <class T>
+static void drawBinAllocatorStats(coord_t y, T & slots)
+{
+  lcdDrawTextAlignedLeft(y, "Lua");
+  lcdDrawNumber(lcdLastRightPos+FW/2, y, slots.slot_size(), LEFT);
+  lcdDrawChar(lcdLastRightPos, y, 'b');
+  lcdDrawNumber(MENU_DEBUG_COL1_OFS, y, slots.size(), LEFT);
+  lcdDrawChar(lcdLastRightPos, y, '/');
+  lcdDrawNumber(lcdLastRightPos, y, slots.peak(), LEFT);
+  lcdDrawChar(lcdLastRightPos, y, '/');
+  lcdDrawNumber(lcdLastRightPos, y, slots.capacity(), LEFT);
+  lcdDrawText(lcdLastRightPos+2, y+1, "[Hits]", SMLSIZE);
+  lcdDrawNumber(lcdLastRightPos, y, slots.hits(), LEFT);
+}
+#endif
+
 void menuStatisticsDebug2(event_t event)
 {
   title(STR_MENUDEBUG);
@@ -234,6 +261,9 @@ void menuStatisticsDebug2(event_t event)
 
     case EVT_KEY_LONG(KEY_ENTER):
       telemetryErrors = 0;
+#if defined(USE_BIN_ALLOCATOR)
+      binAllocatorResetStats();
+#endif
       break;
   }
 
@@ -241,6 +271,14 @@ void menuStatisticsDebug2(event_t event)
   lcdDrawTextAlignedLeft(MENU_DEBUG_ROW1, "Tlm RX Err");
   lcdDrawNumber(MENU_DEBUG_COL1_OFS, MENU_DEBUG_ROW1, telemetryErrors, RIGHT);
 
+#if defined(USE_BIN_ALLOCATOR)
+  // Lua allocator: used / peak / capacity and hits of each slot size
+  drawBinAllocatorStats(MENU_DEBUG_ROW2, slots1);
+  drawBinAllocatorStats(MENU_DEBUG_ROW3, slots2);
+  drawBinAllocatorStats(MENU_DEBUG_ROW4, slots3);
+  lcdDrawTextAlignedLeft(MENU_DEBUG_ROW5, "Lua libc");
+  lcdDrawNumber(MENU_DEBUG_COL1_OFS, MENU_DEBUG_ROW5, binAllocatorFallbacks, LEFT);
+#endif
 
   lcdDrawText(LCD_W/2, 7*FH+1, STR_MENUTORESET, CENTERED);
   lcdInvertLastLine();
@@ -131,3 +131,21 @@ bool InputMixGroup::removeLine(Window* line)
 
   return false;
 }
+
+void InputMixGroup::checkEvents()
+{
+  Window::checkEvents();
+
+  if (idx < MIXSRC_FIRST_CH || idx > MIXSRC_LAST_CH) return;
+
+  // channels part of a loop cannot be ordered by the mixer
+  bool loop = mixerLoopChannels & ((bitfield_channels_t)1 << (idx - MIXSRC_CH1));
+  if (loop != inLoop) {
+    inLoop = loop;
+    if (loop) {
+      lv_obj_set_style_text_color(label, makeLvColor(COLOR_THEME_WARNING), 0);
+    } else {
+      lv_obj_remove_local_style_prop(label, LV_STYLE_TEXT_COLOR, 0);
+    }
+  }
+}
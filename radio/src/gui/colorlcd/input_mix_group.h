@@ -46,6 +46,7 @@ class InputMixGroup : public Window
   lv_obj_t* line_container;
 
   MixerChannelBar* monitor = nullptr;
+  bool inLoop = false;
   
   static void value_changed(lv_event_t* e);
   
@@ -62,4 +63,6 @@ class InputMixGroup : public Window
   
   void addLine(Window* line, const uint8_t* symbol = nullptr);
   bool removeLine(Window* line);
+
+  void checkEvents() override;
 };
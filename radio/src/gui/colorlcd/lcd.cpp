@@ -59,6 +59,57 @@ void lcdSetFlushCb(void (*cb)(lv_disp_drv_t *, uint16_t*, const rect_t&))
 static lv_disp_drv_t* refr_disp = nullptr;
 
 #if !defined(LCD_VERTICAL_INVERT)
+// Areas to copy to the other frame buffer once flushed. Overlapping or
+// neighbouring areas are merged when the bounding box doesn't cost more than
+// copying both areas plus the setup of one DMA transfer.
+#define LCD_DIRTY_AREAS_MAX    8
+#define LCD_DIRTY_MERGE_SLACK  (LCD_W * 2)
+
+struct LcdDirtyAreas {
+  lv_area_t areas[LCD_DIRTY_AREAS_MAX];
+  uint8_t count = 0;
+
+  static bool close(const lv_area_t& a, const lv_area_t& b)
+  {
+    return a.x1 <= b.x2 + 1 && b.x1 <= a.x2 + 1 &&
+           a.y1 <= b.y2 + 1 && b.y1 <= a.y2 + 1;
+  }
+
+  static bool mergeable(const lv_area_t& a, const lv_area_t& b)
+  {
+    lv_area_t u;
+    _lv_area_join(&u, &a, &b);
+    return close(a, b) && lv_area_get_size(&u) <= lv_area_get_size(&a) +
+                                                     lv_area_get_size(&b) +
+                                                     LCD_DIRTY_MERGE_SLACK;
+  }
+
+  void add(const lv_area_t& area)
+  {
+    lv_area_t merged = area;
+    for (uint8_t i = 0; i < count;) {
+      if (mergeable(merged, areas[i])) {
+        _lv_area_join(&merged, &merged, &areas[i]);
+        areas[i] = areas[--count];
+        i = 0;  // the bigger area may now reach previous ones
+      } else {
+        i++;
+      }
+    }
+
+    if (count == LCD_DIRTY_AREAS_MAX) {
+      // too many areas: keep copying one bounding box
+      for (uint8_t i = 1; i < count; i++) {
+        _lv_area_join(&areas[0], &areas[0], &areas[i]);
+      }
+      _lv_area_join(&areas[0], &areas[0], &merged);
+      count = 1;
+      return;
+    }
+    areas[count++] = merged;
+  }
+};
+
 // TODO: DMA copy would be possible (use function from draw_ctx???
 static void _copy_screen_area(uint16_t* dst, uint16_t* src, const lv_area_t& copy_area)
 {
@@ -117,17 +168,23 @@ static void flushLcd(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_
       dst = LCD_FIRST_FRAME_BUFFER;
 
     lv_disp_t* disp = _lv_refr_get_disp_refreshing();
+    LcdDirtyAreas dirty;
     for(int i = 0; i < disp->inv_p; i++) {
       if(disp->inv_area_joined[i]) continue;
+      dirty.add(disp->inv_areas[i]);
+    }
 
-      const lv_area_t& refr_area = disp->inv_areas[i];
+    // The last copy keeps running while the CPU goes on,
+    // lcdRenderStart() waits for it before the next frame is drawn
+    for (uint8_t i = 0; i < dirty.count; i++) {
+      const lv_area_t& refr_area = dirty.areas[i];
 
       auto area_w = refr_area.x2 - refr_area.x1 + 1;
       auto area_h = refr_area.y2 - refr_area.y1 + 1;
 
       DMACopyBitmap(dst, LCD_W, LCD_H, refr_area.x1, refr_area.y1,
                     src, LCD_W, LCD_H, refr_area.x1, refr_area.y1,
-                    area_w, area_h);      
+                    area_w, area_h);
     }
     
     lv_disp_flush_ready(disp_drv);
@@ -137,6 +194,14 @@ static void flushLcd(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_
   }
 }
 
+#if !defined(LCD_VERTICAL_INVERT)
+// The back buffer must be in sync before anything is drawn into it
+static void lcdRenderStart(lv_disp_drv_t * disp_drv)
+{
+  DMAWait();
+}
+#endif
+
 void lcdInitDisplayDriver()
 {
   // we already have a display: exit
@@ -165,6 +230,7 @@ void lcdInitDisplayDriver()
 
 #if !defined(LCD_VERTICAL_INVERT)
   disp_drv.direct_mode = 1;
+  disp_drv.render_start_cb = lcdRenderStart;
 #else
   disp_drv.direct_mode = 0;
 #endif
@@ -193,6 +259,9 @@ void lcdInitDisplayDriver()
 
 void lcdInitDirectDrawing()
 {
+#if !defined(LCD_VERTICAL_INVERT)
+  DMAWait();
+#endif
   lv_draw_ctx_t* draw_ctx = disp->driver->draw_ctx;
   draw_ctx->buf = disp->driver->draw_buf->buf_act;
   draw_ctx->buf_area = &screen_area;
@@ -197,6 +197,9 @@ void DebugViewPage::build(FormWindow *window)
   new DebugInfoNumber<uint16_t>(
       window, grid.getFieldSlot(3, 1), [] { return 10 * maxLuaInterval; },
       COLOR_THEME_PRIMARY1, "[Int] ", "ms");
+  new DebugInfoNumber<uint16_t>(
+      window, grid.getFieldSlot(3, 2), [] { return maxLuaGcDuration; },
+      COLOR_THEME_PRIMARY1, "[GC] ", "us");
   grid.nextLine();
 
   // lUA memory data
@@ -257,15 +260,47 @@ void DebugViewPage::build(FormWindow *window)
   }
 #endif
 
+#if defined(DISK_CACHE)
+  // SD card cache: hit rate, share of hits in the protected queue and
+  // read-ahead efficiency, all in %
+  new StaticText(window, grid.getLabelSlot(), STR_DISK_CACHE_LABEL, 0,
+                 COLOR_THEME_PRIMARY1);
+  new DebugInfoNumber<uint32_t>(
+      window, grid.getFieldSlot(3, 0),
+      [] { return diskCache[0].getHitRate() / 10; }, COLOR_THEME_PRIMARY1,
+      "[Hit] ", nullptr);
+  new DebugInfoNumber<uint32_t>(
+      window, grid.getFieldSlot(3, 1),
+      [] {
+        const DiskCacheStats& stats = diskCache[0].getStats();
+        return stats.noHits ? stats.noProtectedHits * 100 / stats.noHits : 0;
+      },
+      COLOR_THEME_PRIMARY1, "[Prot] ", nullptr);
+  new DebugInfoNumber<uint32_t>(
+      window, grid.getFieldSlot(3, 2),
+      [] {
+        const DiskCacheStats& stats = diskCache[0].getStats();
+        return stats.noReadAheads
+                   ? stats.noReadAheadHits * 100 / stats.noReadAheads
+                   : 0;
+      },
+      COLOR_THEME_PRIMARY1, "[RA] ", nullptr);
+  grid.nextLine();
+#endif
+
   // Reset
   grid.nextLine();
   new TextButton(
       window, grid.getLineSlot(), STR_MENUTORESET,
       [=]() -> uint8_t {
         maxMixerDuration = 0;
+#if defined(DISK_CACHE)
+        diskCache[0].resetStats();
+#endif
 #if defined(LUA)
         maxLuaInterval = 0;
         maxLuaDuration = 0;
+        maxLuaGcDuration = 0;
 #endif
         return 0;
       },
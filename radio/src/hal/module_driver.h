@@ -68,4 +68,7 @@ struct etx_module_driver_t {
 
     // Process input data byte (telemetry)
     void (*processData)(void* context, uint8_t data, uint8_t* buffer, uint8_t* len);
+
+    // Fetch up to len telemetry bytes at once (optional)
+    int (*getBytes)(void* context, uint8_t* data, uint32_t len);
 };
@@ -75,6 +75,9 @@ typedef struct {
   // Fetch byte from internal buffer
   int (*getByte)(void* ctx, uint8_t* data);
 
+  // Fetch up to len bytes from internal buffer, returns the number of bytes
+  int (*getBytes)(void* ctx, uint8_t* data, uint32_t len);
+
   // Clear internal buffer
   void (*clearRxBuffer)(void* ctx);
 
@@ -96,6 +96,7 @@ void initLoggingTimer() {                                       // called cyclic
 #endif
 
 void writeHeader();
+uint32_t getLogicalSwitchesStates(uint8_t first);
 
 #if defined(PCBFRSKY) || defined(PCBNV14) || defined(PCBPL18)
   int getSwitchState(uint8_t swtch) {
@@ -107,6 +108,281 @@ void writeHeader();
   #define GET_3POS_STATE(sw) (switchState(SW_ ## sw ## 0) ? -1 : (switchState(SW_ ## sw ## 2) ? 1 : 0))
 #endif
 
+#if defined(LOG_BINARY)
+// Binary logs: the mixer task packs the logged values into a record in a
+// RAM ring buffer (logsSnapshot()) and logsWrite() only flushes that buffer
+// to the SD card by whole sectors. radio/util/log2csv.py converts the files
+// back to the CSV layout.
+//
+// File layout (little endian):
+//   'E' 'T' 'X' 'L', version, flags
+//   the CSV header line, as written by writeHeader()
+//   sensor columns count, then { kind, prec } for each column
+//   analogs count, switches count, logical switches (0 / 1), channels count
+//   records: 'R', time (u32), ms100 (u8), values...
+// A session appended to an existing file starts again with 'ETXL'.
+
+#define LOGS_BINARY_VERSION      1
+#define LOGS_BINARY_FLAG_RTC     0x01
+#define LOGS_BINARY_RECORD       'R'
+#if defined(COLORLCD)
+  #define LOGS_RING_SIZE         4096
+#else
+  #define LOGS_RING_SIZE         2048
+#endif
+#define LOGS_SECTOR_SIZE         512
+
+#if defined(PCBFRSKY) || defined(PCBFLYSKY)
+  #define LOGS_SWITCHES_STATES   1
+  #define LOGS_SWITCHES_SIZE     (NUM_SWITCHES + 2 * sizeof(uint32_t) + MAX_OUTPUT_CHANNELS * sizeof(int16_t))
+#else
+  #define LOGS_SWITCHES_SIZE     7
+#endif
+
+// Largest record, with all the sensors logged as text. logsFlush() leaves
+// less than a sector in the ring buffer, a record must fit in the rest or
+// no record would ever be written again
+#define LOGS_RECORD_MAX_SIZE     (1 + sizeof(uint32_t) + sizeof(uint8_t) + \
+                                  MAX_TELEMETRY_SENSORS * TELEMETRY_SENSOR_TEXT_LENGTH + \
+                                  (NUM_STICKS + NUM_POTS + NUM_SLIDERS) * sizeof(int16_t) + \
+                                  LOGS_SWITCHES_SIZE + sizeof(uint16_t))
+static_assert(LOGS_RECORD_MAX_SIZE <= LOGS_RING_SIZE - LOGS_SECTOR_SIZE, "LOGS_RING_SIZE too small");
+
+enum LogsColumnKind {
+  LOGS_COLUMN_VALUE,
+  LOGS_COLUMN_GPS,
+  LOGS_COLUMN_DATETIME,
+  LOGS_COLUMN_TEXT,
+};
+
+static uint8_t logsColumnSensor[MAX_TELEMETRY_SENSORS];
+static uint8_t logsColumnKind[MAX_TELEMETRY_SENSORS];
+static uint8_t logsColumnsCount;
+static uint16_t logsRecordSize;
+
+static uint8_t logsRing[LOGS_RING_SIZE];
+static volatile uint16_t logsRingHead;  // only moved by the mixer task
+static volatile uint16_t logsRingTail;  // only moved by logsWrite()
+static volatile bool logsBinaryReady = false;
+static tmr10ms_t lastSnapshotTime = 0;
+
+static uint8_t getLogsColumnKind(const TelemetrySensor & sensor)
+{
+  switch (sensor.unit) {
+    case UNIT_GPS:
+      return LOGS_COLUMN_GPS;
+    case UNIT_DATETIME:
+      return LOGS_COLUMN_DATETIME;
+    case UNIT_TEXT:
+      return LOGS_COLUMN_TEXT;
+    default:
+      return LOGS_COLUMN_VALUE;
+  }
+}
+
+static uint16_t getLogsColumnSize(uint8_t kind)
+{
+  switch (kind) {
+    case LOGS_COLUMN_GPS:
+      return 2 * sizeof(int32_t);
+    case LOGS_COLUMN_DATETIME:
+      return sizeof(uint16_t) + 5 * sizeof(uint8_t);
+    case LOGS_COLUMN_TEXT:
+      return TELEMETRY_SENSOR_TEXT_LENGTH;
+    default:
+      return sizeof(int32_t);
+  }
+}
+
+static uint8_t getLogsSwitchesCount()
+{
+#if defined(LOGS_SWITCHES_STATES)
+  uint8_t count = 0;
+  for (uint8_t i=0; i<NUM_SWITCHES; i++) {
+    if (SWITCH_EXISTS(i)) {
+      count++;
+    }
+  }
+  return count;
+#else
+  return 7;
+#endif
+}
+
+static uint16_t logsRingPut(uint16_t pos, const void * data, uint16_t size)
+{
+  const uint8_t * src = (const uint8_t *)data;
+  while (size--) {
+    logsRing[pos] = *src++;
+    pos = (pos + 1) & (LOGS_RING_SIZE - 1);
+  }
+  return pos;
+}
+
+static void logsBinaryStart()
+{
+  logsColumnsCount = 0;
+  logsRecordSize = 1 + sizeof(uint32_t) + sizeof(uint8_t);
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    if (isTelemetryFieldAvailable(i) && sensor.logs) {
+      uint8_t kind = getLogsColumnKind(sensor);
+      logsColumnSensor[logsColumnsCount] = i;
+      logsColumnKind[logsColumnsCount++] = kind;
+      logsRecordSize += getLogsColumnSize(kind);
+    }
+  }
+
+  uint8_t switches = getLogsSwitchesCount();
+  logsRecordSize += (NUM_STICKS + NUM_POTS + NUM_SLIDERS) * sizeof(int16_t) + switches;
+#if defined(LOGS_SWITCHES_STATES)
+  logsRecordSize += 2 * sizeof(uint32_t) + MAX_OUTPUT_CHANNELS * sizeof(int16_t);
+#endif
+  logsRecordSize += sizeof(uint16_t);
+
+  uint8_t preamble[] = {
+    'E', 'T', 'X', 'L', LOGS_BINARY_VERSION,
+#if defined(RTCLOCK)
+    LOGS_BINARY_FLAG_RTC
+#else
+    0
+#endif
+  };
+  size_t written;
+  g_oLogFile.write(preamble, sizeof(preamble), written);
+  writeHeader();
+
+  g_oLogFile.putc(logsColumnsCount);
+  for (uint8_t i=0; i<logsColumnsCount; i++) {
+    g_oLogFile.putc(logsColumnKind[i]);
+    g_oLogFile.putc(g_model.telemetrySensors[logsColumnSensor[i]].prec);
+  }
+  g_oLogFile.putc(NUM_STICKS + NUM_POTS + NUM_SLIDERS);
+  g_oLogFile.putc(switches);
+#if defined(LOGS_SWITCHES_STATES)
+  g_oLogFile.putc(1);
+  g_oLogFile.putc(MAX_OUTPUT_CHANNELS);
+#else
+  g_oLogFile.putc(0);
+  g_oLogFile.putc(0);
+#endif
+
+  logsRingHead = logsRingTail = 0;
+  lastSnapshotTime = 0;
+  logsBinaryReady = true;
+}
+
+// Called from the mixer task
+void logsSnapshot()
+{
+  if (!logsBinaryReady)
+    return;
+
+  tmr10ms_t tmr10ms = get_tmr10ms();
+  if (lastSnapshotTime != 0 && (tmr10ms_t)(tmr10ms - lastSnapshotTime) < (tmr10ms_t)(logDelay100ms*10)-1)
+    return;
+  lastSnapshotTime = tmr10ms;
+
+  uint16_t head = logsRingHead;
+  uint16_t used = (head - logsRingTail) & (LOGS_RING_SIZE - 1);
+  if (LOGS_RING_SIZE - 1 - used < logsRecordSize) {
+    TRACE("logs: ring buffer full, record dropped");
+    return;
+  }
+
+  uint8_t type = LOGS_BINARY_RECORD;
+  head = logsRingPut(head, &type, sizeof(type));
+
+#if defined(RTCLOCK)
+  uint32_t time = g_rtcTime;
+  uint8_t ms100 = g_ms100;
+#else
+  uint32_t time = tmr10ms;
+  uint8_t ms100 = 0;
+#endif
+  head = logsRingPut(head, &time, sizeof(time));
+  head = logsRingPut(head, &ms100, sizeof(ms100));
+
+  for (uint8_t i=0; i<logsColumnsCount; i++) {
+    TelemetryItem & telemetryItem = telemetryItems[logsColumnSensor[i]];
+    switch (logsColumnKind[i]) {
+      case LOGS_COLUMN_GPS:
+        head = logsRingPut(head, &telemetryItem.gps.latitude, sizeof(int32_t));
+        head = logsRingPut(head, &telemetryItem.gps.longitude, sizeof(int32_t));
+        break;
+      case LOGS_COLUMN_DATETIME:
+        head = logsRingPut(head, &telemetryItem.datetime.year, sizeof(uint16_t));
+        head = logsRingPut(head, &telemetryItem.datetime.month, sizeof(uint8_t));
+        head = logsRingPut(head, &telemetryItem.datetime.day, sizeof(uint8_t));
+        head = logsRingPut(head, &telemetryItem.datetime.hour, sizeof(uint8_t));
+        head = logsRingPut(head, &telemetryItem.datetime.min, sizeof(uint8_t));
+        head = logsRingPut(head, &telemetryItem.datetime.sec, sizeof(uint8_t));
+        break;
+      case LOGS_COLUMN_TEXT:
+        head = logsRingPut(head, telemetryItem.text, TELEMETRY_SENSOR_TEXT_LENGTH);
+        break;
+      default:
+        head = logsRingPut(head, &telemetryItem.value, sizeof(int32_t));
+        break;
+    }
+  }
+
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+    head = logsRingPut(head, &calibratedAnalogs[i], sizeof(int16_t));
+  }
+
+#if defined(LOGS_SWITCHES_STATES)
+  for (uint8_t i=0; i<NUM_SWITCHES; i++) {
+    if (SWITCH_EXISTS(i)) {
+      int8_t state = getSwitchState(i);
+      head = logsRingPut(head, &state, sizeof(state));
+    }
+  }
+  uint32_t lsw[] = { getLogicalSwitchesStates(32), getLogicalSwitchesStates(0) };
+  head = logsRingPut(head, lsw, sizeof(lsw));
+  for (uint8_t channel = 0; channel < MAX_OUTPUT_CHANNELS; channel++) {
+    int16_t output = PPM_CENTER+channelOutputs[channel]/2; // in us
+    head = logsRingPut(head, &output, sizeof(output));
+  }
+#else
+  int8_t states[] = {
+    GET_2POS_STATE(THR),
+    GET_2POS_STATE(RUD),
+    GET_2POS_STATE(ELE),
+    GET_3POS_STATE(ID),
+    GET_2POS_STATE(AIL),
+    GET_2POS_STATE(GEA),
+    GET_2POS_STATE(TRN),
+  };
+  head = logsRingPut(head, states, sizeof(states));
+#endif
+
+  uint16_t vbat = g_vbat100mV;
+  head = logsRingPut(head, &vbat, sizeof(vbat));
+
+  // publish the record once complete
+  logsRingHead = head;
+}
+
+// Writes the ring buffer content by whole sectors, or everything if all
+static bool logsFlush(bool all)
+{
+  while (true) {
+    uint16_t tail = logsRingTail;
+    uint16_t pending = (logsRingHead - tail) & (LOGS_RING_SIZE - 1);
+    if (pending == 0 || (!all && pending < LOGS_SECTOR_SIZE))
+      return true;
+
+    uint16_t len = min<uint16_t>(pending, LOGS_SECTOR_SIZE);
+    len = min<uint16_t>(len, LOGS_RING_SIZE - tail);
+    size_t written;
+    if (g_oLogFile.write(&logsRing[tail], len, written) != VfsError::OK || written != len)
+      return false;
+    logsRingTail = (tail + len) & (LOGS_RING_SIZE - 1);
+  }
+}
+#endif
+
 void logsInit()
 {
   g_oLogFile.close();
@@ -169,23 +445,39 @@ const char * logsOpen()
   tmp = strAppendDate(tmp, true);
 #endif
 
+#if defined(LOG_BINARY)
+  strcpy(tmp, LOGS_BIN_EXT);
+#else
   strcpy(tmp, STR_LOGS_EXT);
+#endif
 
   result = vfs.openFile(g_oLogFile, filename, VfsOpenFlags::OPEN_ALWAYS | VfsOpenFlags::WRITE | VfsOpenFlags::OPEN_APPEND);
   if (result != VfsError::OK) {
     return STORAGE_ERROR(result);
   }
 
+#if defined(LOG_BINARY)
+  logsBinaryStart();
+#else
   if (g_oLogFile.size() == 0) {
     writeHeader();
   }
+#endif
 
   return nullptr;
 }
 
 void logsClose()
 {
+#if defined(LOG_BINARY)
+  logsBinaryReady = false;
+#endif
   if (VirtualFS::instance().sdCardMounted()) {
+#if defined(LOG_BINARY)
+    if (g_oLogFile.isOpen()) {
+      logsFlush(true);
+    }
+#endif
     g_oLogFile.close();
     lastLogTime = 0;
   }
@@ -294,6 +586,13 @@ void logsWrite()
         }
       }
 
+#if defined(LOG_BINARY)
+      if (!logsFlush(false) && !error_displayed) {
+        error_displayed = STR_SDCARD_ERROR;
+        POPUP_WARNING(STR_SDCARD_ERROR);
+        logsClose();
+      }
+#else
 #if defined(RTCLOCK)
       {
         static struct gtm utm;
@@ -383,6 +682,7 @@ void logsWrite()
         POPUP_WARNING(STR_SDCARD_ERROR);
         logsClose();
       }
+#endif
     }
   }
   else {
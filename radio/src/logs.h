@@ -26,5 +26,8 @@ extern uint8_t logDelay;
 void logsInit();
 void logsClose();
 void logsWrite();
+#if defined(LOG_BINARY)
+void logsSnapshot();
+#endif
 
 #endif // _LOGS_H_
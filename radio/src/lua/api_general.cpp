@@ -871,9 +871,7 @@ static int luaSportTelemetryPop(lua_State * L)
 
   if (luaInputTelemetryFifo->size() >= sizeof(SportTelemetryPacket)) {
     SportTelemetryPacket packet;
-    for (uint8_t i=0; i<sizeof(packet); i++) {
-      luaInputTelemetryFifo->pop(packet.raw[i]);
-    }
+    luaInputTelemetryFifo->pop(packet.raw, sizeof(packet));
     lua_pushnumber(L, packet.physicalId);
     lua_pushnumber(L, packet.primId);
     lua_pushnumber(L, packet.dataId);
@@ -1084,17 +1082,17 @@ static int luaCrossfireTelemetryPop(lua_State * L)
     }
   }
 
-  uint8_t length = 0, data = 0;
+  uint8_t length = 0;
   if (luaInputTelemetryFifo->probe(length) && luaInputTelemetryFifo->size() >= uint32_t(length)) {
     // length value includes the length field
-    luaInputTelemetryFifo->pop(length);
-    luaInputTelemetryFifo->pop(data); // command
-    lua_pushnumber(L, data);
+    uint8_t data[256] = {0};
+    luaInputTelemetryFifo->skip();
+    if (length > 1) luaInputTelemetryFifo->pop(data, length - 1);
+    lua_pushnumber(L, data[0]); // command
     lua_newtable(L);
     for (uint8_t i=1; i<length-1; i++) {
-      luaInputTelemetryFifo->pop(data);
       lua_pushinteger(L, i);
-      lua_pushinteger(L, data);
+      lua_pushinteger(L, data[i]);
       lua_settable(L, -3);
     }
     return 2;
@@ -1182,17 +1180,17 @@ static int luaGhostTelemetryPop(lua_State * L)
     }
   }
 
-  uint8_t length = 0, data = 0;
+  uint8_t length = 0;
   if (luaInputTelemetryFifo->probe(length) && luaInputTelemetryFifo->size() >= uint32_t(length)) {
     // length value includes type(1B), payload, crc(1B)
-    luaInputTelemetryFifo->pop(length);
-    luaInputTelemetryFifo->pop(data); // type
-    lua_pushnumber(L, data);          // return type
+    uint8_t data[256] = {0};
+    luaInputTelemetryFifo->skip();
+    if (length > 1) luaInputTelemetryFifo->pop(data, length - 1);
+    lua_pushnumber(L, data[0]);       // return type
     lua_newtable(L);
     for (uint8_t i=0; i<length-2; i++) {
-      luaInputTelemetryFifo->pop(data);
       lua_pushinteger(L, i+1);
-      lua_pushinteger(L, data);
+      lua_pushinteger(L, data[i+1]);
       lua_settable(L, -3);
     }
     return 2;
@@ -2014,12 +2012,16 @@ Get percent of already used Lua instructions in current script execution cycle.
 
 @retval usage (number) a value from 0 to 100 (percent)
 
-@status current Introduced in 2.2.1
+@retval gc (number) time spent in the garbage collector during the last
+cycle, in microseconds
+
+@status current Introduced in 2.2.1, gc added in 2.8.0
 */
 static int luaGetUsage(lua_State * L)
 {
   lua_pushinteger(L, instructionsPercent);
-  return 1;
+  lua_pushinteger(L, luaGcDuration);
+  return 2;
 }
 
 /*luadoc
@@ -24,6 +24,7 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <algorithm>
+#include <vector>
 
 #include "opentx.h"
 #include "bin_allocator.h"
@@ -68,6 +69,8 @@ ScriptInputsOutputs scriptInputsOutputs[MAX_SCRIPTS];
 
 uint16_t maxLuaInterval = 0;
 uint16_t maxLuaDuration = 0;
+uint16_t luaGcDuration = 0;
+uint16_t maxLuaGcDuration = 0;
 uint8_t instructionsPercent = 0;
 tmr10ms_t luaCycleStart;
 char lua_warning_info[LUA_WARNING_INFO_LEN+1];
@@ -324,6 +327,126 @@ void luaDoGc(lua_State * L, bool full)
   }
 }
 
+// Between full collections (when scripts are loaded or unloaded), the
+// collector runs one incremental step per Lua cycle, so that garbage is
+// reclaimed a bit at a time instead of in long stalls. When the memory gets
+// low the collector is made more aggressive and may use the time left in the
+// cycle, and scripts are only killed if even a full collection cannot bring
+// the memory under the limit.
+
+#define LUA_GC_STEP_SIZE           10    // Kb of allocations each step pays for
+#define LUA_GC_MAX_BUDGET_US       5000  // max time per cycle when memory is low
+#define LUA_GC_PRESSURE_PERCENT    80    // of LUA_MEM_MAX, when aggressive mode starts
+#define LUA_GC_LOW_FREE_MEMORY     (8*1024)
+
+#define LUA_GC_DEFAULT_PAUSE       200   // Lua defaults
+#define LUA_GC_DEFAULT_STEPMUL     200
+#define LUA_GC_AGGRESSIVE_PAUSE    100   // start a new cycle as soon as one ends
+#define LUA_GC_AGGRESSIVE_STEPMUL  400
+
+static bool luaGcAggressive = false;
+
+#if (LUA_MEM_MAX > 0)
+static uint32_t luaGetTotalMemUsed()
+{
+  uint32_t totalMemUsed = luaGetMemUsed(lsScripts);
+#if defined(COLORLCD)
+  totalMemUsed += luaGetMemUsed(lsWidgets);
+  totalMemUsed += luaExtraMemoryUsage;
+#endif
+  return totalMemUsed;
+}
+#endif
+
+static bool luaIsMemoryLow()
+{
+#if (LUA_MEM_MAX > 0)
+  if (luaGetTotalMemUsed() > LUA_MEM_MAX / 100 * LUA_GC_PRESSURE_PERCENT)
+    return true;
+#endif
+  return availableMemory() < LUA_GC_LOW_FREE_MEMORY;
+}
+
+static void luaSetGcMode(lua_State * L, bool aggressive)
+{
+  if (L) {
+    lua_gc(L, LUA_GCSETPAUSE, aggressive ? LUA_GC_AGGRESSIVE_PAUSE : LUA_GC_DEFAULT_PAUSE);
+    lua_gc(L, LUA_GCSETSTEPMUL, aggressive ? LUA_GC_AGGRESSIVE_STEPMUL : LUA_GC_DEFAULT_STEPMUL);
+  }
+}
+
+// runs steps until the collector cycle ends or the budget (in 0.5us) is spent,
+// returns the time spent
+static uint16_t luaGcSteps(lua_State * L, uint16_t budget)
+{
+  uint16_t start = getTmr2MHz();
+  uint16_t elapsed = 0;
+
+  PROTECT_LUA() {
+    // at least one step per cycle, so that the collector keeps up
+    do {
+      bool cycleEnded = lua_gc(L, LUA_GCSTEP, LUA_GC_STEP_SIZE);
+      elapsed = (uint16_t)(getTmr2MHz() - start);
+      if (cycleEnded)
+        break;
+    } while (elapsed < budget);
+  }
+  else {
+    // we disable Lua for the rest of the session
+    if (L == lsScripts) luaDisable();
+#if defined(COLORLCD)
+    if (L == lsWidgets) lsWidgets = 0;
+#endif
+  }
+  UNPROTECT_LUA();
+
+  return elapsed;
+}
+
+static void luaGcTask()
+{
+  bool aggressive = luaIsMemoryLow();
+  if (aggressive != luaGcAggressive) {
+    TRACE("Lua GC %s mode", aggressive ? "aggressive" : "normal");
+    luaGcAggressive = aggressive;
+    luaSetGcMode(lsScripts, aggressive);
+#if defined(COLORLCD)
+    luaSetGcMode(lsWidgets, aggressive);
+#endif
+  }
+
+  // a single step, unless memory is low: then what is left of the Lua cycle,
+  // capped to leave the UI responsive
+  uint32_t budget = 0;
+  if (aggressive) {
+    tmr10ms_t spent = get_tmr10ms() - luaCycleStart;
+    budget = spent < LUA_TASK_PERIOD_TICKS ? (LUA_TASK_PERIOD_TICKS - spent) * 10000 : 0;
+    if (budget > LUA_GC_MAX_BUDGET_US)
+      budget = LUA_GC_MAX_BUDGET_US;
+    budget *= 2;  // 2MHz timer
+  }
+
+  uint16_t elapsed = 0;
+  if (lsScripts) {
+#if defined(COLORLCD)
+    // share the budget with the widgets
+    elapsed += luaGcSteps(lsScripts, budget / 2);
+#else
+    elapsed += luaGcSteps(lsScripts, budget);
+#endif
+  }
+#if defined(COLORLCD)
+  if (lsWidgets) {
+    elapsed += luaGcSteps(lsWidgets, elapsed < budget ? budget - elapsed : 0);
+  }
+#endif
+
+  luaGcDuration = elapsed / 2;
+  if (luaGcDuration > maxLuaGcDuration) {
+    maxLuaGcDuration = luaGcDuration;
+  }
+}
+
 void luaFree(lua_State * L, ScriptInternalData & sid)
 {
   PROTECT_LUA() {
@@ -363,8 +486,9 @@ static int luaDumpWriter(lua_State * L, const void* p, size_t size, void* u)
   @param stripDebug This is passed directly to luaU_dump()
     1 = remove debug info from bytecode (smaller but errors are less informative)
     0 = keep debug info
+  @retval true if the file was saved (with the timestamp from finfo)
 */
-static void luaDumpState(lua_State * L, const char * filename, const VfsFileInfo* finfo, int stripDebug)
+static bool luaDumpState(lua_State * L, const char * filename, const VfsFileInfo* finfo, int stripDebug)
 {
   VfsFile D;
   VirtualFS& vfs = VirtualFS::instance();
@@ -373,13 +497,287 @@ static void luaDumpState(lua_State * L, const char * filename, const VfsFileInfo
     luaU_dump(L, getproto(L->top - 1), luaDumpWriter, &D, stripDebug);
     lua_unlock(L);
     if (D.close() == VfsError::OK) {
-      if (finfo != nullptr)
-        vfs.utime(filename, *finfo);  // set the file mod time
+      if (finfo != nullptr && vfs.utime(filename, *finfo) != VfsError::OK)  // set the file mod time
+        return false;
       TRACE("luaDumpState(%s): Saved bytecode to file.", filename);
+      return true;
     }
   } else
     TRACE_ERROR("luaDumpState(%s): Error: Could not open output file\n", filename);
+  return false;
+}
+
+#if defined(LUA_BUNDLE)
+// While scripts and widgets are loaded, their bytecode is read from a single
+// bundle file instead of comparing, opening and reading the .lua and .luac
+// files of each of them. Entries are keyed by the path, size and date of the
+// .lua file they were compiled from: a script which changed is loaded the
+// usual way, and at the end of the loading the bundle is rebuilt from the
+// .luac files, in loading order so that the next loading reads it
+// sequentially.
+
+#define LUA_BUNDLE_MAGIC        "ELB1"
+#define LUA_BUNDLE_TMP_FILE     SCRIPTS_PATH PATH_SEPARATOR "BUNDLE.tmp"
+#if defined(COLORLCD)
+  #define LUA_BUNDLE_MAX_ENTRIES  48
+#else
+  #define LUA_BUNDLE_MAX_ENTRIES  16
+#endif
+#define LUA_BUNDLE_BUFFER_SIZE  256
+
+PACK(struct LuaBundleHeader {
+  char     magic[4];
+  uint8_t  count;
+  uint8_t  spare[3];
+});
+
+PACK(struct LuaBundleEntry {
+  uint32_t hash;    // path of the .lua file, without extension
+  uint32_t size;    // size and date of the .lua file
+  uint16_t date;
+  uint16_t time;
+  uint32_t offset;  // bytecode in the bundle
+  uint32_t length;
+});
+
+// what was loaded, in order: a bundle entry, or a path to take from its .luac
+struct LuaBundleItem {
+  int16_t entry;
+  uint32_t hash;
+  std::string path;
+};
+
+static struct {
+  bool open;
+  VfsFile file;
+  uint8_t count;
+  LuaBundleEntry * entries;
+  std::vector<LuaBundleItem> items;
+  bool dirty;
+} luaBundle;
+
+struct LuaBundleReader {
+  VfsFile * file;
+  uint32_t left;
+  char buffer[LUA_BUNDLE_BUFFER_SIZE];
+};
+
+static uint32_t luaBundleHash(const char * path, size_t len)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ (uint8_t)path[i]) * 16777619u;
+  }
+  return hash;
+}
+
+static const char * luaBundleRead(lua_State * L, void * ud, size_t * size)
+{
+  UNUSED(L);
+  LuaBundleReader * reader = (LuaBundleReader *)ud;
+  size_t count = min<uint32_t>(reader->left, sizeof(reader->buffer));
+  if (count == 0 || reader->file->read(reader->buffer, count, *size) != VfsError::OK || *size == 0) {
+    *size = 0;
+    return nullptr;
+  }
+  reader->left -= *size;
+  return reader->buffer;
 }
+
+bool luaBundleBegin()
+{
+  if (luaBundle.open)
+    return false;
+
+  luaBundle.open = true;
+  luaBundle.count = 0;
+  luaBundle.dirty = false;
+  luaBundle.items.clear();
+  luaBundle.entries = (LuaBundleEntry *)malloc(LUA_BUNDLE_MAX_ENTRIES * sizeof(LuaBundleEntry));
+  if (!luaBundle.entries)
+    return true;
+
+  LuaBundleHeader header;
+  size_t read;
+  if (VirtualFS::instance().openFile(luaBundle.file, SCRIPTS_BUNDLE_FILE, VfsOpenFlags::OPEN_EXISTING | VfsOpenFlags::READ) == VfsError::OK) {
+    if (luaBundle.file.read(&header, sizeof(header), read) == VfsError::OK && read == sizeof(header) &&
+        !memcmp(header.magic, LUA_BUNDLE_MAGIC, sizeof(header.magic)) && header.count <= LUA_BUNDLE_MAX_ENTRIES &&
+        luaBundle.file.read(luaBundle.entries, header.count * sizeof(LuaBundleEntry), read) == VfsError::OK &&
+        read == header.count * sizeof(LuaBundleEntry)) {
+      luaBundle.count = header.count;
+    }
+  }
+
+  TRACE("luaBundleBegin(): %d entries", luaBundle.count);
+  return true;
+}
+
+static bool luaBundleLoad(lua_State * L, uint32_t hash, const char * filename, VfsFileInfo & info)
+{
+  for (uint8_t i = 0; i < luaBundle.count; i++) {
+    const LuaBundleEntry & entry = luaBundle.entries[i];
+    if (entry.hash == hash && entry.size == info.getSize() && entry.date == (uint16_t)info.getDate() && entry.time == (uint16_t)info.getTime()) {
+      LuaBundleReader reader;
+      reader.file = &luaBundle.file;
+      reader.left = entry.length;
+      if (luaBundle.file.lseek(entry.offset) != VfsError::OK)
+        return false;
+      std::string chunkname = std::string("@") + filename;
+      if (lua_load(L, luaBundleRead, &reader, chunkname.c_str(), "b") != LUA_OK) {
+        TRACE_ERROR("luaBundleLoad(%s): %s\n", filename, lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return false;
+      }
+      luaBundle.items.push_back({(int16_t)i, hash, std::string()});
+      return true;
+    }
+  }
+  return false;
+}
+
+static void luaBundleMiss(uint32_t hash, const char * path, size_t len)
+{
+  if (luaBundle.open) {
+    luaBundle.items.push_back({-1, hash, std::string(path, len)});
+    luaBundle.dirty = true;
+  }
+}
+
+static bool luaBundleCopy(VfsFile & dst, VfsFile & src, uint32_t length)
+{
+  uint8_t buffer[LUA_BUNDLE_BUFFER_SIZE];
+  while (length > 0) {
+    size_t count = min<uint32_t>(length, sizeof(buffer));
+    size_t read, written;
+    if (src.read(buffer, count, read) != VfsError::OK || read != count ||
+        dst.write(buffer, count, written) != VfsError::OK || written != count)
+      return false;
+    length -= count;
+  }
+  return true;
+}
+
+// new entries: what was loaded, in order, then what is left of the old bundle
+static void luaBundleWrite()
+{
+  VirtualFS& vfs = VirtualFS::instance();
+  LuaBundleEntry * entries = (LuaBundleEntry *)malloc(LUA_BUNDLE_MAX_ENTRIES * sizeof(LuaBundleEntry));
+  int16_t * sources = (int16_t *)malloc(LUA_BUNDLE_MAX_ENTRIES * sizeof(int16_t));  // old entry, or -1 - item
+  uint8_t count = 0;
+  uint32_t offset = sizeof(LuaBundleHeader);
+
+  if (!entries || !sources) {
+    free(entries);
+    free(sources);
+    return;
+  }
+
+  auto isNew = [&](uint32_t hash) {
+    for (uint8_t i = 0; i < count; i++) {
+      if (entries[i].hash == hash)
+        return false;
+    }
+    return true;
+  };
+
+  for (size_t i = 0; i < luaBundle.items.size() && count < LUA_BUNDLE_MAX_ENTRIES; i++) {
+    const LuaBundleItem & item = luaBundle.items[i];
+    if (!isNew(item.hash))
+      continue;
+    if (item.entry >= 0) {
+      entries[count] = luaBundle.entries[item.entry];
+      sources[count++] = item.entry;
+    }
+    else {
+      // the .luac file must have been compiled from the current .lua file
+      VfsFileInfo infoS, infoC;
+      if (vfs.fstat(item.path + SCRIPT_EXT, infoS) == VfsError::OK &&
+          vfs.fstat(item.path + SCRIPT_BIN_EXT, infoC) == VfsError::OK &&
+          infoS.getDate() == infoC.getDate() && infoS.getTime() == infoC.getTime()) {
+        LuaBundleEntry & entry = entries[count];
+        entry.hash = item.hash;
+        entry.size = infoS.getSize();
+        entry.date = infoS.getDate();
+        entry.time = infoS.getTime();
+        entry.length = infoC.getSize();
+        sources[count++] = -1 - (int16_t)i;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < luaBundle.count && count < LUA_BUNDLE_MAX_ENTRIES; i++) {
+    if (isNew(luaBundle.entries[i].hash)) {
+      entries[count] = luaBundle.entries[i];
+      sources[count++] = i;
+    }
+  }
+
+  offset += count * sizeof(LuaBundleEntry);
+  for (uint8_t i = 0; i < count; i++) {
+    entries[i].offset = offset;
+    offset += entries[i].length;
+  }
+
+  VfsFile file;
+  if (vfs.openFile(file, LUA_BUNDLE_TMP_FILE, VfsOpenFlags::CREATE_ALWAYS | VfsOpenFlags::WRITE) == VfsError::OK) {
+    LuaBundleHeader header;
+    memclear(&header, sizeof(header));
+    memcpy(header.magic, LUA_BUNDLE_MAGIC, sizeof(header.magic));
+    header.count = count;
+
+    size_t written;
+    bool ok = (file.write(&header, sizeof(header), written) == VfsError::OK && written == sizeof(header) &&
+               file.write(entries, count * sizeof(LuaBundleEntry), written) == VfsError::OK &&
+               written == count * sizeof(LuaBundleEntry));
+
+    for (uint8_t i = 0; ok && i < count; i++) {
+      if (sources[i] >= 0) {
+        const LuaBundleEntry & old = luaBundle.entries[sources[i]];
+        ok = (luaBundle.file.lseek(old.offset) == VfsError::OK && luaBundleCopy(file, luaBundle.file, old.length));
+      }
+      else {
+        VfsFile luac;
+        ok = (vfs.openFile(luac, luaBundle.items[-1 - sources[i]].path + SCRIPT_BIN_EXT, VfsOpenFlags::OPEN_EXISTING | VfsOpenFlags::READ) == VfsError::OK &&
+              luaBundleCopy(file, luac, entries[i].length));
+        luac.close();
+      }
+    }
+
+    if (file.close() != VfsError::OK)
+      ok = false;
+
+    luaBundle.file.close();
+    if (ok) {
+      vfs.unlink(SCRIPTS_BUNDLE_FILE);
+      ok = (vfs.rename(LUA_BUNDLE_TMP_FILE, SCRIPTS_BUNDLE_FILE) == VfsError::OK);
+    }
+    if (!ok) {
+      vfs.unlink(LUA_BUNDLE_TMP_FILE);
+    }
+    TRACE("luaBundleWrite(): %d entries%s", count, ok ? "" : ", failed");
+  }
+
+  free(entries);
+  free(sources);
+}
+
+void luaBundleEnd()
+{
+  if (!luaBundle.open)
+    return;
+
+  if (luaBundle.dirty && luaBundle.entries) {
+    luaBundleWrite();
+  }
+
+  luaBundle.file.close();
+  free(luaBundle.entries);
+  luaBundle.entries = nullptr;
+  luaBundle.count = 0;
+  std::vector<LuaBundleItem>().swap(luaBundle.items);
+  luaBundle.open = false;
+}
+#endif  // LUA_BUNDLE
 #endif  // LUA_COMPILER
 
 /**
@@ -448,6 +846,17 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
   fnamelen++; // for the added colon in filename
   strncat(filenameFull, filename, fnamelen);
 
+#if defined(LUA_BUNDLE)
+  uint32_t bundleHash = luaBundleHash(filenameFull + 1, fnamelen - 1);
+  if (luaBundle.open && strchr(lmode, 'b') && !strchr(lmode, 'c')) {
+    strcpy(filenameFull + fnamelen, SCRIPT_EXT);
+    if (vfs.fstat(filenameFull+1, fnoLuaS) == VfsError::OK && luaBundleLoad(L, bundleHash, filenameFull+1, fnoLuaS)) {
+      TRACE("luaLoadScriptFileToState(%s, %s): loaded from bundle", filename, lmode);
+      return SCRIPT_OK;
+    }
+  }
+#endif
+
   // check if binary version exists
   strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
   frLuaC = vfs.fstat(filenameFull+1, fnoLuaC);
@@ -526,10 +935,20 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
     lstatus = luaL_loadfilex(L, filenameFull, nullptr);
   }
   if (lstatus == LUA_OK) {
+    // the bundle can only take a .luac compiled from the current .lua
+    bool luacMatches = (frLuaS == VfsError::OK && frLuaC == VfsError::OK &&
+                        fnoLuaC.getDate() == fnoLuaS.getDate() && fnoLuaC.getTime() == fnoLuaS.getTime());
     if (scriptNeedsCompile && loadFileType == 1) {
       strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
-      luaDumpState(L, filenameFull, &fnoLuaS, (strchr(lmode, 'd') ? 0 : 1));
+      luacMatches = luaDumpState(L, filenameFull, &fnoLuaS, (strchr(lmode, 'd') ? 0 : 1));
     }
+#if defined(LUA_BUNDLE)
+    if (luacMatches) {
+      luaBundleMiss(bundleHash, filenameFull + 1, fnamelen - 1);
+    }
+#else
+    (void)luacMatches;
+#endif
     ret = SCRIPT_OK;
   }
 #else
@@ -811,6 +1230,10 @@ static void luaLoadScripts(bool init, const char * filename = nullptr)
   if (init) {
     luaInit();
     if (luaState == INTERPRETER_PANIC) return;
+#if defined(LUA_BUNDLE)
+    luaBundleEnd();  // previous loading may have been aborted
+    luaBundleBegin();
+#endif
    
     luaLcdAllowed = false;
     initFunction = LUA_NOREF;
@@ -953,6 +1376,9 @@ static void luaLoadScripts(bool init, const char * filename = nullptr)
   } while(++ref < SCRIPT_STANDALONE);
  
   // Loading has finished - start running scripts
+#if defined(LUA_BUNDLE)
+  luaBundleEnd();
+#endif
   luaState = INTERPRETER_START_RUNNING;
 } // luaLoadScripts
 
@@ -969,7 +1395,6 @@ static bool resumeLua(bool init, bool allowLcdUsage)
   if (init) idx = 0;
 
   bool scriptWasRun = false;
-  bool fullGC = !allowLcdUsage;
   static uint8_t luaDisplayStatistics = false;
  
   // Run in the right interactive mode
@@ -1082,10 +1507,6 @@ static bool resumeLua(bool init, bool allowLcdUsage)
       }
     }
     
-    // Full garbage collection at the start of every cycle
-    luaDoGc(lsScripts, fullGC);
-    fullGC = false;
-
     // Resume running the coroutine
     luaStatus = lua_resume(lsScripts, 0, inputsCount);
 
@@ -1225,6 +1646,7 @@ bool luaTask(event_t evt, bool allowLcdUsage)
       }
       else luaDisable();
       UNPROTECT_LUA();
+      luaGcTask();
   }
   return scriptWasRun;
 }
@@ -1232,11 +1654,15 @@ bool luaTask(event_t evt, bool allowLcdUsage)
 void checkLuaMemoryUsage()
 {
 #if (LUA_MEM_MAX > 0)
-  uint32_t totalMemUsed = luaGetMemUsed(lsScripts);
+  uint32_t totalMemUsed = luaGetTotalMemUsed();
+  if (totalMemUsed > LUA_MEM_MAX) {
+    // last chance before killing Lua
+    luaDoGc(lsScripts, true);
 #if defined(COLORLCD)
-  totalMemUsed += luaGetMemUsed(lsWidgets);
-  totalMemUsed += luaExtraMemoryUsage;
+    luaDoGc(lsWidgets, true);
 #endif
+    totalMemUsed = luaGetTotalMemUsed();
+  }
   if (totalMemUsed > LUA_MEM_MAX) {
     TRACE_ERROR("checkLuaMemoryUsage(): max limit reached (%u), killing Lua\n", totalMemUsed);
     // disable Lua scripts
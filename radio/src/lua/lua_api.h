@@ -171,6 +171,10 @@ bool luaTask(event_t evt, bool allowLcdUsage);
 void checkLuaMemoryUsage();
 void luaExec(const char * filename);
 void luaDoGc(lua_State * L, bool full);
+#if defined(LUA_BUNDLE)
+bool luaBundleBegin();
+void luaBundleEnd();
+#endif
 uint32_t luaGetMemUsed(lua_State * L);
 void luaGetValueAndPush(lua_State * L, int src);
 bool isTelemetryScriptAvailable();
@@ -198,6 +202,8 @@ extern struct our_longjmp * global_lj;
 
 extern uint16_t maxLuaInterval;
 extern uint16_t maxLuaDuration;
+extern uint16_t luaGcDuration;
+extern uint16_t maxLuaGcDuration;
 extern uint8_t instructionsPercent;
 
 #if defined(KEYS_GPIO_REG_PAGE)
@@ -376,7 +376,13 @@ void luaInitThemesAndWidgets()
     }
     UNPROTECT_LUA();
     TRACE("lsWidgets %p", lsWidgets);
+#if defined(LUA_BUNDLE)
+    bool bundle = luaBundleBegin();
+#endif
     luaLoadFiles(WIDGETS_PATH, luaLoadWidgetCallback);
+#if defined(LUA_BUNDLE)
+    if (bundle) luaBundleEnd();
+#endif
     luaDoGc(lsWidgets, true);
   }
 }
@@ -160,6 +160,9 @@ void handleUsbConnection()
 
       if (getSelectedUsbMode() == USB_MASS_STORAGE_MODE) {
         opentxClose(false);
+#if defined(DISK_CACHE_WRITEBACK)
+        diskCacheSuspend();
+#endif
       }
 #if defined(USB_SERIAL)
       else if (getSelectedUsbMode() == USB_SERIAL_MODE) {
@@ -176,6 +179,9 @@ void handleUsbConnection()
     usbStop();
     TRACE("USB stopped");
     if (getSelectedUsbMode() == USB_MASS_STORAGE_MODE) {
+#if defined(DISK_CACHE_WRITEBACK)
+      diskCacheResume();
+#endif
       opentxResume();
       pushEvent(EVT_ENTRY);
     } else if (getSelectedUsbMode() == USB_SERIAL_MODE) {
@@ -507,6 +513,9 @@ void perMain()
       logsWrite();         // call logsWrite the old way for simu
     #endif
 #endif // SDCARD
+#if defined(DISK_CACHE_WRITEBACK)
+    diskCacheCheckTimeout();
+#endif
   }
 
   handleUsbConnection();
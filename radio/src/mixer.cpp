@@ -145,10 +145,52 @@ int expo(int x, int k)
   return neg ? -y : y;
 }
 
-void applyExpos(int16_t * anas, uint8_t mode, uint8_t ovwrIdx, int16_t ovwrValue)
+// The result of each input line only depends on its source value, the
+// flight mode and the model data (curves, weight, offset, see
+// modelDataRevision), including the GVAR values (see gvarsRevision). The
+// mixer task keeps the last result of each line and reuses it while none of
+// them changed, skipping the curve and the GVAR resolutions.
+
+#define EXPO_CACHE_INVALID 0xFF
+
+struct ExpoCacheLine {
+  int16_t input;       // source value, scaled and limited
+  int16_t output;      // value after curve, weight and offset
+  uint8_t flightMode;  // EXPO_CACHE_INVALID when empty
+};
+
+static ExpoCacheLine expoCache[MAX_EXPOS];
+static uint32_t expoCacheRevision;
+static uint32_t expoCacheGVarsRevision;
+static bool expoCacheValid = false;
+
+ExpoCacheStats expoCacheStats;
+
+static void checkExpoCache()
+{
+  if (expoCacheValid && expoCacheRevision == modelDataRevision &&
+      expoCacheGVarsRevision == gvarsRevision)
+    return;
+
+  for (auto & line: expoCache) {
+    line.flightMode = EXPO_CACHE_INVALID;
+  }
+  expoCacheRevision = modelDataRevision;
+  expoCacheGVarsRevision = gvarsRevision;
+  expoCacheValid = true;
+}
+
+// ovwr: the input editors preview the lines of the source ovwrIdx with
+// ovwrValue from the UI task, they don't use the cache
+static void applyExpoLines(int16_t * anas, uint8_t mode, bool ovwr, mixsrc_t ovwrIdx, int16_t ovwrValue)
 {
   int8_t cur_chn = -1;
 
+  bool useCache = (mode <= e_perout_mode_inactive_flight_mode && !ovwr);
+  if (useCache) {
+    checkExpoCache();
+  }
+
   for (uint8_t i=0; i<MAX_EXPOS; i++) {
     if (mode == e_perout_mode_normal) swOn[i].activeExpo = false;
     ExpoData * ed = expoAddress(i);
@@ -161,7 +203,7 @@ void applyExpos(int16_t * anas, uint8_t mode, uint8_t ovwrIdx, int16_t ovwrValue
       continue;
     if (getSwitch(ed->swtch)) {
       int32_t v;
-      if (ed->srcRaw == ovwrIdx) {
+      if (ovwr && ed->srcRaw == ovwrIdx) {
         v = ovwrValue;
       }
       else {
@@ -175,18 +217,34 @@ void applyExpos(int16_t * anas, uint8_t mode, uint8_t ovwrIdx, int16_t ovwrValue
         if (mode == e_perout_mode_normal) swOn[i].activeExpo = true;
         cur_chn = ed->chn;
 
-        //========== CURVE=================
-        if (ed->curve.value) {
-          v = applyCurve(v, ed->curve);
+        ExpoCacheLine & cache = expoCache[i];
+        if (useCache && cache.flightMode == mixerCurrentFlightMode && cache.input == v) {
+          expoCacheStats.hits++;
+          v = cache.output;
         }
+        else {
+          int16_t input = v;
+
+          //========== CURVE=================
+          if (ed->curve.value) {
+            v = applyCurve(v, ed->curve, useCache);
+          }
+
+          //========== WEIGHT ===============
+          int32_t weight = GET_GVAR_PREC1(ed->weight, -100, 100, mixerCurrentFlightMode);
+          v = divRoundClosest((int32_t)v * weight, 1000);
 
-        //========== WEIGHT ===============
-        int32_t weight = GET_GVAR_PREC1(ed->weight, -100, 100, mixerCurrentFlightMode);
-        v = divRoundClosest((int32_t)v * weight, 1000);
+          //========== OFFSET ===============
+          int32_t offset = GET_GVAR_PREC1(ed->offset, -100, 100, mixerCurrentFlightMode);
+          if (offset) v += divRoundClosest(calc100toRESX(offset), 10);
 
-        //========== OFFSET ===============
-        int32_t offset = GET_GVAR_PREC1(ed->offset, -100, 100, mixerCurrentFlightMode);
-        if (offset) v += divRoundClosest(calc100toRESX(offset), 10);
+          if (useCache) {
+            expoCacheStats.misses++;
+            cache.input = input;
+            cache.output = v;
+            cache.flightMode = mixerCurrentFlightMode;
+          }
+        }
 
         //========== TRIMS ================
         if (ed->carryTrim < TRIM_ON)
@@ -201,6 +259,16 @@ void applyExpos(int16_t * anas, uint8_t mode, uint8_t ovwrIdx, int16_t ovwrValue
   }
 }
 
+void applyExpos(int16_t * anas, uint8_t mode)
+{
+  applyExpoLines(anas, mode, false, 0, 0);
+}
+
+void applyExpos(int16_t * anas, uint8_t mode, mixsrc_t ovwrIdx, int16_t ovwrValue)
+{
+  applyExpoLines(anas, mode, true, ovwrIdx, ovwrValue);
+}
+
 // #define PREVENT_ARITHMETIC_OVERFLOW
 // because of optimizations the reserves before overruns occurs is only the half
 // this defines enables some checks the greatly improves this situation
@@ -238,9 +306,9 @@ int16_t applyLimits(uint8_t channel, int32_t value)
   if (lim->curve) {
     // TODO we loose precision here, applyCustomCurve could work with int32_t on ARM boards...
     if (lim->curve > 0)
-      value = 256 * applyCustomCurve(value/256, lim->curve-1);
+      value = 256 * applyCachedCurve(value/256, lim->curve-1);
     else
-      value = 256 * applyCustomCurve(-value/256, -lim->curve-1);
+      value = 256 * applyCachedCurve(-value/256, -lim->curve-1);
   }
 
   int16_t ofs   = LIMIT_OFS_RESX(lim);
@@ -624,9 +692,242 @@ int getSourceTrimValue(int source, int stickValue=0)
   }
 }
 
+// The mixer lines are pre-decoded into a flat plan each time the model
+// changes (see modelDataRevision), so that evalFlightModeMixes() only walks
+// the lines in use and does not need to decode sources, weights and offsets
+// at every tick.
+//
+// The lines are grouped by destination channel, and the channels are sorted
+// so that a channel used as a source by another one is always computed
+// first: every channel is then evaluated exactly once per tick. Channels
+// belonging to a loop (CH1 uses CH2 which uses CH1) cannot be sorted, they
+// read the value of the previous tick and are reported in mixerLoopChannels.
+
+enum MixPlanSource {
+  MIX_PLAN_SRC_GENERIC,  // resolved at runtime through getValue()
+  MIX_PLAN_SRC_INPUT,
+  MIX_PLAN_SRC_ANALOG,
+  MIX_PLAN_SRC_CHANNEL,
+  MIX_PLAN_SRC_MAX,
+};
+
+enum MixPlanFlags {
+  MIX_PLAN_FIRST_LINE = 0x01,   // first line of its destination channel
+  MIX_PLAN_TRAINER = 0x02,      // trainer source
+  MIX_PLAN_LUA = 0x04,          // Lua source, srcIndex is the script index
+  MIX_PLAN_GVAR_WEIGHT = 0x08,  // weight must be resolved at runtime
+  MIX_PLAN_GVAR_OFFSET = 0x10,  // offset must be resolved at runtime
+};
+
+struct MixPlanLine {
+  uint8_t index;     // index in g_model.mixData
+  uint8_t source;    // MixPlanSource
+  uint8_t srcIndex;  // index in anas / calibratedAnalogs / ex_chans
+  uint8_t flags;     // MixPlanFlags
+  int32_t weight;    // already converted to the 256 basis
+  int32_t offset;    // already converted to RESX << 8
+};
+
+struct MixPlan {
+  bool valid;
+  uint32_t revision;
+  uint8_t count;    // lines in the plan
+  uint8_t scanned;  // MixData entries covered by the plan (holes included)
+  bitfield_channels_t channels;  // channels with at least one line
+  MixPlanLine lines[MAX_MIXERS];
+};
+
+static MixPlan mixPlan;
+
+bitfield_channels_t mixerLoopChannels = 0;
+
+static void compileMixPlanLine(MixPlanLine & line, uint8_t index, bool first)
+{
+  MixData * md = mixAddress(index);
+
+  line.index = index;
+  line.source = MIX_PLAN_SRC_GENERIC;
+  line.srcIndex = 0;
+  line.flags = first ? MIX_PLAN_FIRST_LINE : 0;
+
+  // same decoding as getValue(), anything else stays generic
+  mixsrc_t src = md->srcRaw;
+  if (src <= MIXSRC_LAST_INPUT) {
+    line.source = MIX_PLAN_SRC_INPUT;
+    line.srcIndex = src - MIXSRC_FIRST_INPUT;
+  }
+#if defined(LUA_INPUTS)
+  else if (src <= MIXSRC_LAST_LUA) {
+#if defined(LUA_MODEL_SCRIPTS)
+    line.flags |= MIX_PLAN_LUA;
+    line.srcIndex = (src - MIXSRC_FIRST_LUA) / MAX_SCRIPT_OUTPUTS;
+#endif
+  }
+#endif
+  else if (src >= MIXSRC_Rud && src <= MIXSRC_LAST_POT + NUM_MOUSE_ANALOGS) {
+    line.source = MIX_PLAN_SRC_ANALOG;
+    line.srcIndex = src - MIXSRC_Rud;
+  }
+  else if (src == MIXSRC_MAX) {
+    line.source = MIX_PLAN_SRC_MAX;
+  }
+  else if (src >= MIXSRC_FIRST_TRAINER && src <= MIXSRC_LAST_TRAINER) {
+    line.flags |= MIX_PLAN_TRAINER;
+  }
+  else if (src >= MIXSRC_CH1 && src <= MIXSRC_LAST_CH) {
+    line.source = MIX_PLAN_SRC_CHANNEL;
+    line.srcIndex = src - MIXSRC_CH1;
+  }
+
+#if defined(GVARS)
+  if (GV_IS_GV_VALUE(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE)) {
+    line.flags |= MIX_PLAN_GVAR_WEIGHT;
+    line.weight = 0;
+  }
+  else
+#endif
+  {
+    int32_t weight = GET_GVAR_PREC1(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, 0);
+    line.weight = calc100to256_16Bits(weight);
+  }
+
+#if defined(GVARS)
+  if (GV_IS_GV_VALUE(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE)) {
+    line.flags |= MIX_PLAN_GVAR_OFFSET;
+    line.offset = 0;
+  }
+  else
+#endif
+  {
+    int32_t offset = GET_GVAR_PREC1(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, 0);
+    line.offset = offset ? divRoundClosest(calc100toRESX_16Bits(offset), 10) << 8 : 0;
+  }
+}
+
+static void compileMixPlan()
+{
+  uint32_t revision = modelDataRevision;
+  uint8_t scanned = MAX_MIXERS;
+  bitfield_channels_t used = 0;
+  bitfield_channels_t deps[MAX_OUTPUT_CHANNELS];
+
+  memclear(deps, sizeof(deps));
+
+  for (uint8_t i = 0; i < MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+
+    if (md->srcRaw == 0) {
+#if defined(COLORLCD)
+      continue;
+#else
+      scanned = i + 1;
+      break;
+#endif
+    }
+
+    used |= (bitfield_channels_t)1 << md->destCh;
+    if (md->srcRaw >= MIXSRC_CH1 && md->srcRaw <= MIXSRC_LAST_CH) {
+      uint8_t srcCh = md->srcRaw - MIXSRC_CH1;
+      if (srcCh != md->destCh)
+        deps[md->destCh] |= (bitfield_channels_t)1 << srcCh;
+    }
+  }
+
+  // channels without any line are always up-to-date
+  for (uint8_t ch = 0; ch < MAX_OUTPUT_CHANNELS; ch++) {
+    deps[ch] &= used;
+  }
+
+  // channels which can reach themselves through their sources
+  bitfield_channels_t loops = 0;
+  for (uint8_t ch = 0; ch < MAX_OUTPUT_CHANNELS; ch++) {
+    bitfield_channels_t reach = deps[ch];
+    bitfield_channels_t visited = 0;
+    while (reach & ~visited) {
+      bitfield_channels_t next = reach & ~visited;
+      visited |= next;
+      for (uint8_t src = 0; src < MAX_OUTPUT_CHANNELS; src++) {
+        if (next & ((bitfield_channels_t)1 << src))
+          reach |= deps[src];
+      }
+    }
+    if (reach & ((bitfield_channels_t)1 << ch))
+      loops |= (bitfield_channels_t)1 << ch;
+  }
+
+  // order the channels: lowest channel whose sources are all computed first,
+  // and when only loops are left, break the lowest one
+  uint8_t order[MAX_OUTPUT_CHANNELS];
+  uint8_t channels = 0;
+  bitfield_channels_t done = ~used;
+  while (~done) {
+    int8_t next = -1;
+    for (uint8_t ch = 0; ch < MAX_OUTPUT_CHANNELS && next < 0; ch++) {
+      bitfield_channels_t mask = (bitfield_channels_t)1 << ch;
+      if (!(done & mask) && !(deps[ch] & ~done))
+        next = ch;
+    }
+    for (uint8_t ch = 0; ch < MAX_OUTPUT_CHANNELS && next < 0; ch++) {
+      bitfield_channels_t mask = (bitfield_channels_t)1 << ch;
+      if (!(done & mask) && (loops & mask))
+        next = ch;
+    }
+    for (uint8_t ch = 0; ch < MAX_OUTPUT_CHANNELS && next < 0; ch++) {
+      if (!(done & ((bitfield_channels_t)1 << ch)))
+        next = ch;
+    }
+    order[channels++] = next;
+    done |= (bitfield_channels_t)1 << next;
+  }
+
+  uint8_t count = 0;
+  for (uint8_t o = 0; o < channels; o++) {
+    bool first = true;
+    for (uint8_t i = 0; i < scanned; i++) {
+      MixData * md = mixAddress(i);
+      if (md->srcRaw != 0 && md->destCh == order[o]) {
+        compileMixPlanLine(mixPlan.lines[count++], i, first);
+        first = false;
+      }
+    }
+  }
+
+  mixPlan.count = count;
+  mixPlan.scanned = scanned;
+  mixPlan.channels = used;
+  mixPlan.revision = revision;
+  mixPlan.valid = true;
+  mixerLoopChannels = loops;
+}
+
+static inline void checkMixPlan()
+{
+  if (mixPlan.valid && mixPlan.revision == modelDataRevision)
+    return;
+  compileMixPlan();
+}
+
+static inline getvalue_t getMixPlanValue(const MixPlanLine & line, const MixData * md)
+{
+  switch (line.source) {
+    case MIX_PLAN_SRC_INPUT:
+      return anas[line.srcIndex];
+    case MIX_PLAN_SRC_ANALOG:
+      return calibratedAnalogs[line.srcIndex];
+    case MIX_PLAN_SRC_CHANNEL:
+      return ex_chans[line.srcIndex];
+    case MIX_PLAN_SRC_MAX:
+      return 1024;
+    default:
+      return getValue(md->srcRaw);
+  }
+}
+
 uint8_t mixerCurrentFlightMode;
 void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 {
+  checkMixPlan();
+
   evalInputs(mode);
 
   if (tick10ms)
@@ -701,265 +1002,257 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
   //========== MIXER LOOP ===============
   uint8_t lv_mixWarning = 0;
 
-  uint8_t pass = 0;
-
-  bitfield_channels_t dirtyChannels = (bitfield_channels_t)-1; // all dirty when mixer starts
-
-  do {
-    bitfield_channels_t passDirtyChannels = 0;
-
-    for (uint8_t i=0; i<MAX_MIXERS; i++) {
-      if (mode == e_perout_mode_normal && pass == 0)
-        swOn[i].activeMix = 0;
-
-      MixData * md = mixAddress(i);
+  // channels without any line are already computed (0)
+  bitfield_channels_t doneChannels = ~mixPlan.channels;
+  bitfield_channels_t currentChannel = 0;
 
-      if (md->srcRaw == 0)
-#if defined(COLORLCD)
-        continue;
-#else
-        break;
-#endif
-
-      mixsrc_t stickIndex = md->srcRaw - MIXSRC_Rud;
-
-      if (!(dirtyChannels & ((bitfield_channels_t)1 << md->destCh)))
-        continue;
+  if (mode == e_perout_mode_normal) {
+    for (uint8_t i=0; i<mixPlan.scanned; i++)
+      swOn[i].activeMix = 0;
+  }
 
-      // if this is the first calculation for the destination channel, initialize it with 0 (otherwise would be random)
-      if (i == 0 || md->destCh != (md-1)->destCh)
-        chans[md->destCh] = 0;
+  for (uint8_t l=0; l<mixPlan.count; l++) {
+    const MixPlanLine & line = mixPlan.lines[l];
+    uint8_t i = line.index;
+    MixData * md = mixAddress(i);
+
+    // if this is the first calculation for the destination channel, initialize it with 0 (otherwise would be random)
+    if (line.flags & MIX_PLAN_FIRST_LINE) {
+      // all lines of the previous channel have been evaluated
+      doneChannels |= currentChannel;
+      currentChannel = (bitfield_channels_t)1 << md->destCh;
+      chans[md->destCh] = 0;
+    }
 
-      //========== FLIGHT MODE && SWITCH =====
-      bool mixCondition = (md->flightModes != 0 || md->swtch);
-      delayval_t mixEnabled = (!(md->flightModes & (1 << mixerCurrentFlightMode)) && getSwitch(md->swtch)) ? DELAY_POS_MARGIN+1 : 0;
+    //========== FLIGHT MODE && SWITCH =====
+    bool mixCondition = (md->flightModes != 0 || md->swtch);
+    delayval_t mixEnabled = (!(md->flightModes & (1 << mixerCurrentFlightMode)) && getSwitch(md->swtch)) ? DELAY_POS_MARGIN+1 : 0;
 
 #define MIXER_LINE_DISABLE()   (mixCondition = true, mixEnabled = 0)
 
-      if (mixEnabled && md->srcRaw >= MIXSRC_FIRST_TRAINER && md->srcRaw <= MIXSRC_LAST_TRAINER && !IS_TRAINER_INPUT_VALID()) {
-        MIXER_LINE_DISABLE();
-      }
+    if (mixEnabled && (line.flags & MIX_PLAN_TRAINER) && !IS_TRAINER_INPUT_VALID()) {
+      MIXER_LINE_DISABLE();
+    }
 
 #if defined(LUA_MODEL_SCRIPTS)
-      // disable mixer if Lua script is used as source and script was killed
-      if (mixEnabled && md->srcRaw >= MIXSRC_FIRST_LUA && md->srcRaw <= MIXSRC_LAST_LUA) {
-        div_t qr = div(md->srcRaw-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
-        if (scriptInternalData[qr.quot].state != SCRIPT_OK) {
-          MIXER_LINE_DISABLE();
-        }
+    // disable mixer if Lua script is used as source and script was killed
+    if (mixEnabled && (line.flags & MIX_PLAN_LUA)) {
+      if (scriptInternalData[line.srcIndex].state != SCRIPT_OK) {
+        MIXER_LINE_DISABLE();
       }
+    }
 #endif
 
-      //========== VALUE ===============
-      getvalue_t v = 0;
-      if (mode > e_perout_mode_inactive_flight_mode) {
-        if (mixEnabled)
-          v = getValue(md->srcRaw);
-        else
-          continue;
+    //========== VALUE ===============
+    getvalue_t v = 0;
+    if (mode > e_perout_mode_inactive_flight_mode) {
+      if (mixEnabled)
+        v = getMixPlanValue(line, md);
+      else
+        continue;
+    }
+    else {
+      v = getMixPlanValue(line, md);
+      // channels already computed during this tick are used directly,
+      // the other ones (loops) keep the value of the previous tick
+      if (line.source == MIX_PLAN_SRC_CHANNEL && (doneChannels & ((bitfield_channels_t)1 << line.srcIndex))) {
+        v = chans[line.srcIndex] >> 8;
       }
-      else {
-        mixsrc_t srcRaw = MIXSRC_Rud + stickIndex;
-        v = getValue(srcRaw);
-        srcRaw -= MIXSRC_CH1;
-        if (srcRaw <= MIXSRC_LAST_CH-MIXSRC_CH1 && md->destCh != srcRaw) {
-          if (dirtyChannels & ((bitfield_channels_t)1 << srcRaw) & (passDirtyChannels|~(((bitfield_channels_t) 1 << md->destCh)-1)))
-            passDirtyChannels |= (bitfield_channels_t) 1 << md->destCh;
-          if (srcRaw < md->destCh || pass > 0)
-            v = chans[srcRaw] >> 8;
-        }
-        if (!mixCondition) {
-          mixEnabled = v;
-        }
+      if (!mixCondition) {
+        mixEnabled = v;
       }
+    }
 
-      bool applyOffsetAndCurve = true;
-
-      //========== DELAYS ===============
-      delayval_t _swOn = swOn[i].now;
-      delayval_t _swPrev = swOn[i].prev;
-      bool swTog = (mixEnabled > _swOn+DELAY_POS_MARGIN || mixEnabled < _swOn-DELAY_POS_MARGIN);
-      if (mode == e_perout_mode_normal && swTog) {
-        if (!swOn[i].delay)
-          _swPrev = _swOn;
-        swOn[i].delay = (mixEnabled > _swOn ? md->delayUp : md->delayDown) * 10;
-        swOn[i].now = mixEnabled;
-        swOn[i].prev = _swPrev;
-      }
-      if (mode == e_perout_mode_normal && swOn[i].delay > 0) {
-        swOn[i].delay = max<int16_t>(0, (int16_t)swOn[i].delay - tick10ms);
-        if (!mixCondition)
-          v = _swPrev;
-        else if (mixEnabled)
-          continue;
+    bool applyOffsetAndCurve = true;
+
+    //========== DELAYS ===============
+    delayval_t _swOn = swOn[i].now;
+    delayval_t _swPrev = swOn[i].prev;
+    bool swTog = (mixEnabled > _swOn+DELAY_POS_MARGIN || mixEnabled < _swOn-DELAY_POS_MARGIN);
+    if (mode == e_perout_mode_normal && swTog) {
+      if (!swOn[i].delay)
+        _swPrev = _swOn;
+      swOn[i].delay = (mixEnabled > _swOn ? md->delayUp : md->delayDown) * 10;
+      swOn[i].now = mixEnabled;
+      swOn[i].prev = _swPrev;
+    }
+    if (mode == e_perout_mode_normal && swOn[i].delay > 0) {
+      swOn[i].delay = max<int16_t>(0, (int16_t)swOn[i].delay - tick10ms);
+      if (!mixCondition)
+        v = _swPrev;
+      else if (mixEnabled)
+        continue;
+    }
+    else {
+      if (mode==e_perout_mode_normal) {
+        swOn[i].now = swOn[i].prev = mixEnabled;
       }
-      else {
-        if (mode==e_perout_mode_normal) {
-          swOn[i].now = swOn[i].prev = mixEnabled;
-        }
-        if (!mixEnabled) {
-          if ((md->speedDown || md->speedUp) && md->mltpx!=MLTPX_REPL) {
-            if (mixCondition) {
-              v = (md->mltpx == MLTPX_ADD ? 0 : RESX);
-              applyOffsetAndCurve = false;
-            }
-          }
-          else if (mixCondition) {
-            continue;
+      if (!mixEnabled) {
+        if ((md->speedDown || md->speedUp) && md->mltpx!=MLTPX_REPL) {
+          if (mixCondition) {
+            v = (md->mltpx == MLTPX_ADD ? 0 : RESX);
+            applyOffsetAndCurve = false;
           }
         }
+        else if (mixCondition) {
+          continue;
+        }
       }
+    }
 
-      if (mode==e_perout_mode_normal && (!mixCondition || mixEnabled || swOn[i].delay)) {
-        if (md->mixWarn)
-          lv_mixWarning |= 1 << (md->mixWarn - 1);
-        swOn[i].activeMix = true;
-      }
+    if (mode==e_perout_mode_normal && (!mixCondition || mixEnabled || swOn[i].delay)) {
+      if (md->mixWarn)
+        lv_mixWarning |= 1 << (md->mixWarn - 1);
+      swOn[i].activeMix = true;
+    }
 
-      if (applyOffsetAndCurve) {
-        bool applyTrims = !(mode & e_perout_mode_notrims);
-        if (!applyTrims && g_model.thrTrim) {
-          auto origin = getSourceTrimOrigin(md->srcRaw);
-          if (origin == g_model.getThrottleStickTrimSource() - MIXSRC_FIRST_TRIM) {
-            applyTrims = true;
-          }
-        }
-        if (applyTrims && md->carryTrim == 0) {
-          v += getSourceTrimValue(md->srcRaw, v);
+    if (applyOffsetAndCurve) {
+      bool applyTrims = !(mode & e_perout_mode_notrims);
+      if (!applyTrims && g_model.thrTrim) {
+        auto origin = getSourceTrimOrigin(md->srcRaw);
+        if (origin == g_model.getThrottleStickTrimSource() - MIXSRC_FIRST_TRIM) {
+          applyTrims = true;
         }
       }
+      if (applyTrims && md->carryTrim == 0) {
+        v += getSourceTrimValue(md->srcRaw, v);
+      }
+    }
 
-      int32_t weight = GET_GVAR_PREC1(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
+    int32_t weight = line.weight;
+    if (line.flags & MIX_PLAN_GVAR_WEIGHT) {
+      weight = GET_GVAR_PREC1(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
       weight = calc100to256_16Bits(weight);
-      //========== SPEED ===============
-      // now its on input side, but without weight compensation. More like other remote controls
-      // lower weight causes slower movement
+    }
+    //========== SPEED ===============
+    // now its on input side, but without weight compensation. More like other remote controls
+    // lower weight causes slower movement
 
-      if (mode <= e_perout_mode_inactive_flight_mode && (md->speedUp || md->speedDown)) { // there are delay values
+    if (mode <= e_perout_mode_inactive_flight_mode && (md->speedUp || md->speedDown)) { // there are delay values
 #define DEL_MULT_SHIFT 8
-        // we recale to a mult 256 higher value for calculation
-        int32_t tact = act[i];
-        int16_t diff = v - (tact>>DEL_MULT_SHIFT);
-        if (diff) {
-          // open.20.fsguruh: speed is defined in % movement per second; In menu we specify the full movement (-100% to 100%) = 200% in total
-          // the unit of the stored value is the value from md->speedUp or md->speedDown * 0.1s; e.g. value 4 means 0.4 seconds
-          // because we get a tick each 10msec, we need 100 ticks for one second
-          // the value in md->speedXXX gives the time it should take to do a full movement from -100 to 100 therefore 200%. This equals 2048 in recalculated internal range
-          if (tick10ms || !s_mixer_first_run_done) {
-            // only if already time is passed add or substract a value according the speed configured
-            int32_t rate = (int32_t) tick10ms << (DEL_MULT_SHIFT+11);  // = DEL_MULT*2048*tick10ms
-            // rate equals a full range for one second; if less time is passed rate is accordingly smaller
-            // if one second passed, rate would be 2048 (full motion)*256(recalculated weight)*100(100 ticks needed for one second)
-            int32_t currentValue = ((int32_t) v<<DEL_MULT_SHIFT);
-            if (diff > 0) {
-              if (s_mixer_first_run_done && md->speedUp > 0) {
-                // if a speed upwards is defined recalculate the new value according configured speed; the higher the speed the smaller the add value is
-                int32_t newValue = tact+rate/((int16_t)10*md->speedUp);
-                if (newValue<currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
-              }
+      // we recale to a mult 256 higher value for calculation
+      int32_t tact = act[i];
+      int16_t diff = v - (tact>>DEL_MULT_SHIFT);
+      if (diff) {
+        // open.20.fsguruh: speed is defined in % movement per second; In menu we specify the full movement (-100% to 100%) = 200% in total
+        // the unit of the stored value is the value from md->speedUp or md->speedDown * 0.1s; e.g. value 4 means 0.4 seconds
+        // because we get a tick each 10msec, we need 100 ticks for one second
+        // the value in md->speedXXX gives the time it should take to do a full movement from -100 to 100 therefore 200%. This equals 2048 in recalculated internal range
+        if (tick10ms || !s_mixer_first_run_done) {
+          // only if already time is passed add or substract a value according the speed configured
+          int32_t rate = (int32_t) tick10ms << (DEL_MULT_SHIFT+11);  // = DEL_MULT*2048*tick10ms
+          // rate equals a full range for one second; if less time is passed rate is accordingly smaller
+          // if one second passed, rate would be 2048 (full motion)*256(recalculated weight)*100(100 ticks needed for one second)
+          int32_t currentValue = ((int32_t) v<<DEL_MULT_SHIFT);
+          if (diff > 0) {
+            if (s_mixer_first_run_done && md->speedUp > 0) {
+              // if a speed upwards is defined recalculate the new value according configured speed; the higher the speed the smaller the add value is
+              int32_t newValue = tact+rate/((int16_t)10*md->speedUp);
+              if (newValue<currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
             }
-            else {  // if is <0 because ==0 is not possible
-              if (s_mixer_first_run_done && md->speedDown > 0) {
-                // see explanation in speedUp
-                int32_t newValue = tact-rate/((int16_t)10*md->speedDown);
-                if (newValue>currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
-              }
+          }
+          else {  // if is <0 because ==0 is not possible
+            if (s_mixer_first_run_done && md->speedDown > 0) {
+              // see explanation in speedUp
+              int32_t newValue = tact-rate/((int16_t)10*md->speedDown);
+              if (newValue>currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
             }
-            act[i] = tact = currentValue;
-            // open.20.fsguruh: this implementation would save about 50 bytes code
-          } // endif tick10ms ; in case no time passed assign the old value, not the current value from source
-          v = (tact >> DEL_MULT_SHIFT);
-        }
+          }
+          act[i] = tact = currentValue;
+          // open.20.fsguruh: this implementation would save about 50 bytes code
+        } // endif tick10ms ; in case no time passed assign the old value, not the current value from source
+        v = (tact >> DEL_MULT_SHIFT);
       }
+    }
 
-      //========== CURVES ===============
-      if (applyOffsetAndCurve && md->curve.type != CURVE_REF_DIFF && md->curve.value) {
-        v = applyCurve(v, md->curve);
-      }
+    //========== CURVES ===============
+    if (applyOffsetAndCurve && md->curve.type != CURVE_REF_DIFF && md->curve.value) {
+      v = applyCurve(v, md->curve, true);
+    }
 
-      //========== WEIGHT ===============
-      int32_t dv = (int32_t)v * weight;
-      dv = divRoundClosest(dv, 10);
+    //========== WEIGHT ===============
+    int32_t dv = (int32_t)v * weight;
+    dv = divRoundClosest(dv, 10);
 
-      //========== OFFSET / AFTER ===============
-      if (applyOffsetAndCurve) {
+    //========== OFFSET / AFTER ===============
+    if (applyOffsetAndCurve) {
+      if (line.flags & MIX_PLAN_GVAR_OFFSET) {
         int32_t offset = GET_GVAR_PREC1(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
         if (offset) dv += divRoundClosest(calc100toRESX_16Bits(offset), 10) << 8;
       }
-
-      //========== DIFFERENTIAL =========
-      if (md->curve.type == CURVE_REF_DIFF && md->curve.value) {
-        dv = applyCurve(dv, md->curve);
+      else {
+        dv += line.offset;
       }
+    }
 
-      int32_t * ptr = &chans[md->destCh]; // Save calculating address several times
+    //========== DIFFERENTIAL =========
+    if (md->curve.type == CURVE_REF_DIFF && md->curve.value) {
+      dv = applyCurve(dv, md->curve, true);
+    }
 
-      switch (md->mltpx) {
-        case MLTPX_REPL:
-          *ptr = dv;
-          if (mode == e_perout_mode_normal) {
-            for (uint8_t m=i-1; m<MAX_MIXERS && mixAddress(m)->destCh==md->destCh; m--)
-              swOn[m].activeMix = false;
-          }
-          break;
-        case MLTPX_MUL:
-          // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
-          dv >>= 8;
-          dv *= *ptr;
-          dv >>= RESX_SHIFT;   // same as dv /= RESXl;
-          *ptr = dv;
-          break;
-        default: // MLTPX_ADD
-          *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
-          break;
-      } // endswitch md->mltpx
+    int32_t * ptr = &chans[md->destCh]; // Save calculating address several times
+
+    switch (md->mltpx) {
+      case MLTPX_REPL:
+        *ptr = dv;
+        if (mode == e_perout_mode_normal) {
+          for (uint8_t m=i-1; m<MAX_MIXERS && mixAddress(m)->destCh==md->destCh; m--)
+            swOn[m].activeMix = false;
+        }
+        break;
+      case MLTPX_MUL:
+        // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
+        dv >>= 8;
+        dv *= *ptr;
+        dv >>= RESX_SHIFT;   // same as dv /= RESXl;
+        *ptr = dv;
+        break;
+      default: // MLTPX_ADD
+        *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
+        break;
+    } // endswitch md->mltpx
 #ifdef PREVENT_ARITHMETIC_OVERFLOW
 /*
-      // a lot of assumptions must be true, for this kind of check; not really worth for only 4 bytes flash savings
-      // this solution would save again 4 bytes flash
-      int8_t testVar=(*ptr<<1)>>24;
-      if ( (testVar!=-1) && (testVar!=0 ) ) {
-        // this devices by 64 which should give a good balance between still over 100% but lower then 32x100%; should be OK
-        *ptr >>= 6;  // this is quite tricky, reduces the value a lot but should be still over 100% and reduces flash need
-      } */
-
-
-      PACK( union u_int16int32_t {
-        struct {
-          int16_t lo;
-          int16_t hi;
-        } words_t;
-        int32_t dword;
-      });
-
-      u_int16int32_t tmp;
-      tmp.dword=*ptr;
-
-      if (tmp.dword<0) {
-        if ((tmp.words_t.hi&0xFF80)!=0xFF80) tmp.words_t.hi=0xFF86; // set to min nearly
-      }
-      else {
-        if ((tmp.words_t.hi|0x007F)!=0x007F) tmp.words_t.hi=0x0079; // set to max nearly
-      }
-      *ptr = tmp.dword;
-      // this implementation saves 18bytes flash
+    // a lot of assumptions must be true, for this kind of check; not really worth for only 4 bytes flash savings
+    // this solution would save again 4 bytes flash
+    int8_t testVar=(*ptr<<1)>>24;
+    if ( (testVar!=-1) && (testVar!=0 ) ) {
+      // this devices by 64 which should give a good balance between still over 100% but lower then 32x100%; should be OK
+      *ptr >>= 6;  // this is quite tricky, reduces the value a lot but should be still over 100% and reduces flash need
+    } */
+
+
+    PACK( union u_int16int32_t {
+      struct {
+        int16_t lo;
+        int16_t hi;
+      } words_t;
+      int32_t dword;
+    });
+
+    u_int16int32_t tmp;
+    tmp.dword=*ptr;
+
+    if (tmp.dword<0) {
+      if ((tmp.words_t.hi&0xFF80)!=0xFF80) tmp.words_t.hi=0xFF86; // set to min nearly
+    }
+    else {
+      if ((tmp.words_t.hi|0x007F)!=0x007F) tmp.words_t.hi=0x0079; // set to max nearly
+    }
+    *ptr = tmp.dword;
+    // this implementation saves 18bytes flash
 
 /*      dv=*ptr>>8;
-      if (dv>(32767-RESXl)) {
-        *ptr=(32767-RESXl)<<8;
-      } else if (dv<(-32767+RESXl)) {
-        *ptr=(-32767+RESXl)<<8;
-      }*/
-      // *ptr=limit( int32_t(int32_t(-1)<<23), *ptr, int32_t(int32_t(1)<<23));  // limit code cost 72 bytes
-      // *ptr=limit( int32_t((-32767+RESXl)<<8), *ptr, int32_t((32767-RESXl)<<8));  // limit code cost 80 bytes
+    if (dv>(32767-RESXl)) {
+      *ptr=(32767-RESXl)<<8;
+    } else if (dv<(-32767+RESXl)) {
+      *ptr=(-32767+RESXl)<<8;
+    }*/
+    // *ptr=limit( int32_t(int32_t(-1)<<23), *ptr, int32_t(int32_t(1)<<23));  // limit code cost 72 bytes
+    // *ptr=limit( int32_t((-32767+RESXl)<<8), *ptr, int32_t((32767-RESXl)<<8));  // limit code cost 80 bytes
 #endif
 
-    } //endfor mixers
-
-    tick10ms = 0;
-    dirtyChannels &= passDirtyChannels;
-
-  } while (++pass < 5 && dirtyChannels);
+  } //endfor mixers
 
   mixWarning = lv_mixWarning;
 }
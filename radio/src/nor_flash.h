@@ -68,6 +68,7 @@ const char RADIO_SETTINGS_YAML_PATH[] = RADIO_PATH PATH_SEPARATOR "radio.yml";
 
 #define MODELS_EXT          ".bin"
 #define LOGS_EXT            ".csv"
+#define LOGS_BIN_EXT        ".etl"
 #define SOUNDS_EXT          ".wav"
 #define BMP_EXT             ".bmp"
 #define PNG_EXT             ".png"
@@ -605,6 +605,8 @@ inline void pauseMixerCalculations()
 
 inline void resumeMixerCalculations()
 {
+  // mixes / inputs may have been moved while the mixer was paused
+  modelDataRevision++;
   RTOS_UNLOCK_MUTEX(mixerMutex);
 }
 #endif
@@ -709,7 +711,17 @@ inline void getGVarIncDecRange(int16_t & valMin, int16_t & valMax)
 }
 #endif
 
-void applyExpos(int16_t * anas, uint8_t mode, uint8_t ovwrIdx=0, int16_t ovwrValue=0);
+void applyExpos(int16_t * anas, uint8_t mode);
+// input editors preview: the lines using the source ovwrIdx get ovwrValue
+void applyExpos(int16_t * anas, uint8_t mode, mixsrc_t ovwrIdx, int16_t ovwrValue);
+
+// Input lines reused from the previous mixer run / computed again
+struct ExpoCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+};
+extern ExpoCacheStats expoCacheStats;
+
 int16_t applyLimits(uint8_t channel, int32_t value);
 
 void evalInputs(uint8_t mode);
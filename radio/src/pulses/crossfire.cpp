@@ -33,10 +33,19 @@
 #define CROSSFIRE_CENTER            0x3E0
 #if defined(PPM_CENTER_ADJUSTABLE)
   #define CROSSFIRE_CENTER_CH_OFFSET(ch)            ((2 * limitAddress(ch)->ppmCenter) + 1)  // + 1 is for rouding
+  #define CROSSFIRE_SUBSET_CH_OFFSET(ch)            (2 * limitAddress(ch)->ppmCenter)
 #else
   #define CROSSFIRE_CENTER_CH_OFFSET(ch)            (0)
+  #define CROSSFIRE_SUBSET_CH_OFFSET(ch)            (0)
 #endif
 
+// Subset frames: 11 bits channels, 0.5us per step, centered on 1500us
+#define CROSSFIRE_SUBSET_RES_11BITS 1
+#define CROSSFIRE_SUBSET_CENTER     0x400
+#define CROSSFIRE_SUBSET_MAX        0x7FF
+
+// A full frame is still sent every CROSSFIRE_SUBSET_FULL_INTERVAL frames
+#define CROSSFIRE_SUBSET_FULL_INTERVAL  8
 
 uint8_t createCrossfireModelIDFrame(uint8_t moduleIdx, uint8_t * frame)
 {
@@ -54,30 +63,128 @@ uint8_t createCrossfireModelIDFrame(uint8_t moduleIdx, uint8_t * frame)
   return buf - frame;
 }
 
+// 8 channels of 11 bits fill exactly 11 bytes
+static inline void crossfirePack8Channels(uint8_t * buf, const uint16_t * v)
+{
+  buf[0] = v[0];
+  buf[1] = (v[0] >> 8) | (v[1] << 3);
+  buf[2] = (v[1] >> 5) | (v[2] << 6);
+  buf[3] = v[2] >> 2;
+  buf[4] = (v[2] >> 10) | (v[3] << 1);
+  buf[5] = (v[3] >> 7) | (v[4] << 4);
+  buf[6] = (v[4] >> 4) | (v[5] << 7);
+  buf[7] = v[5] >> 1;
+  buf[8] = (v[5] >> 9) | (v[6] << 2);
+  buf[9] = (v[6] >> 6) | (v[7] << 5);
+  buf[10] = v[7] >> 3;
+}
+
+// Packs count 11 bits values, LSB first, returns the number of bytes written
+static uint8_t crossfirePackChannels(uint8_t * buf, const uint16_t * values, uint8_t count)
+{
+  uint8_t * start = buf;
+  for (; count >= 8; count -= 8, values += 8, buf += 11) {
+    crossfirePack8Channels(buf, values);
+  }
+  if (count > 0) {
+    uint16_t tail[8] = {0};
+    uint8_t packed[11];
+    memcpy(tail, values, count * sizeof(uint16_t));
+    crossfirePack8Channels(packed, tail);
+    uint8_t len = (count * CROSSFIRE_CH_BITS + 7) / 8;
+    memcpy(buf, packed, len);
+    buf += len;
+  }
+  return buf - start;
+}
+
 // Range for pulses (channels output) is [-1024:+1024]
-uint8_t createCrossfireChannelsFrame(uint8_t * frame, int16_t * pulses)
+// Channels above nChannels are sent centered
+uint8_t createCrossfireChannelsFrame(uint8_t * frame, int16_t * pulses, uint8_t nChannels)
 {
+  uint16_t values[CROSSFIRE_CHANNELS_COUNT];
+  for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
+    int16_t pulse = (i < nChannels ? pulses[i] : 0);
+    values[i] = limit(0, CROSSFIRE_CENTER + (CROSSFIRE_CENTER_CH_OFFSET(i) * 4) / 5 + (pulse * 4) / 5, 2 * CROSSFIRE_CENTER);
+  }
+
   uint8_t * buf = frame;
   *buf++ = MODULE_ADDRESS;
   *buf++ = 24; // 1(ID) + 22 + 1(CRC)
   uint8_t * crc_start = buf;
   *buf++ = CHANNELS_ID;
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
-  for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
-    uint32_t val = limit(0, CROSSFIRE_CENTER + (CROSSFIRE_CENTER_CH_OFFSET(i) * 4) / 5 + (pulses[i] * 4) / 5, 2 * CROSSFIRE_CENTER);
-    bits |= val << bitsavailable;
-    bitsavailable += CROSSFIRE_CH_BITS;
-    while (bitsavailable >= 8) {
-      *buf++ = bits;
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
-  }
+  buf += crossfirePackChannels(buf, values, CROSSFIRE_CHANNELS_COUNT);
   *buf++ = crc8(crc_start, 23);
   return buf - frame;
 }
 
+// Subset frame carrying only channels [first, first + count[
+uint8_t createCrossfireSubsetChannelsFrame(uint8_t * frame, int16_t * pulses, uint8_t first, uint8_t count)
+{
+  uint16_t values[CROSSFIRE_CHANNELS_COUNT];
+  for (int i=0; i<count; i++) {
+    uint8_t ch = first + i;
+    values[i] = limit(0, CROSSFIRE_SUBSET_CENTER + CROSSFIRE_SUBSET_CH_OFFSET(ch) + pulses[ch], CROSSFIRE_SUBSET_MAX);
+  }
+
+  uint8_t * buf = frame;
+  *buf++ = MODULE_ADDRESS;
+  uint8_t * len = buf++;
+  uint8_t * crc_start = buf;
+  *buf++ = SUBSET_CHANNELS_ID;
+  *buf++ = (first & 0x1F) | (CROSSFIRE_SUBSET_RES_11BITS << 5);
+  buf += crossfirePackChannels(buf, values, count);
+  *len = buf - crc_start + 1;
+  *buf = crc8(crc_start, buf - crc_start);
+  buf++;
+  return buf - frame;
+}
+
+#if defined(CROSSFIRE_SUBSET_CHANNELS)
+struct CrossfireChannelsState {
+  int16_t sent[CROSSFIRE_CHANNELS_COUNT];
+  uint8_t subsetFrames;
+  uint8_t keepAlive;      // next channel sent when nothing changed
+};
+
+static CrossfireChannelsState crossfireChannelsState[NUM_MODULES];
+
+// Sends only the channels which changed since the last frame, with a full
+// frame every CROSSFIRE_SUBSET_FULL_INTERVAL frames
+static uint8_t createCrossfireChangedChannelsFrame(uint8_t idx, uint8_t * frame, int16_t * pulses, uint8_t nChannels)
+{
+  auto & state = crossfireChannelsState[idx];
+  if (nChannels > CROSSFIRE_CHANNELS_COUNT)
+    nChannels = CROSSFIRE_CHANNELS_COUNT;
+
+  int8_t first = -1, last = -1;
+  if (state.subsetFrames > 0) {
+    for (int i = 0; i < nChannels; i++) {
+      if (pulses[i] != state.sent[i]) {
+        if (first < 0) first = i;
+        last = i;
+      }
+    }
+  }
+
+  memcpy(state.sent, pulses, nChannels * sizeof(int16_t));
+
+  if (state.subsetFrames == 0 || last - first >= CROSSFIRE_CHANNELS_COUNT / 2) {
+    state.subsetFrames = CROSSFIRE_SUBSET_FULL_INTERVAL - 1;
+    return createCrossfireChannelsFrame(frame, pulses, nChannels);
+  }
+
+  state.subsetFrames--;
+  if (first < 0) {
+    // nothing changed, keep the link fed with one channel, in turn
+    if (state.keepAlive >= nChannels)
+      state.keepAlive = 0;
+    first = last = state.keepAlive++;
+  }
+  return createCrossfireSubsetChannelsFrame(frame, pulses, first, last - first + 1);
+}
+#endif
+
 static void setupPulsesCrossfire(uint8_t idx, CrossfirePulsesData* p_data,
                                  uint8_t endpoint, int16_t* channels,
                                  uint8_t nChannels)
@@ -94,10 +201,17 @@ static void setupPulsesCrossfire(uint8_t idx, CrossfirePulsesData* p_data,
     if (moduleState[idx].counter == CRSF_FRAME_MODELID) {
       p_data->length = createCrossfireModelIDFrame(idx, p_data->pulses);
       moduleState[idx].counter = CRSF_FRAME_MODELID_SENT;
+#if defined(CROSSFIRE_SUBSET_CHANNELS)
+      crossfireChannelsState[idx].subsetFrames = 0;
+#endif
     } else {
+#if defined(CROSSFIRE_SUBSET_CHANNELS)
+      p_data->length = createCrossfireChangedChannelsFrame(
+          idx, p_data->pulses, channels, nChannels);
+#else
       p_data->length = createCrossfireChannelsFrame(
-          p_data->pulses,
-          channels /*TODO: nChannels*/);
+          p_data->pulses, channels, nChannels);
+#endif
     }
   }
 }
@@ -112,19 +226,13 @@ static void crossfireSetupMixerScheduler(uint8_t module)
   }
 }
 
-static bool _checkFrameCRC(uint8_t* rxBuffer)
-{
-  uint8_t len = rxBuffer[1];
-  uint8_t crc = crc8(&rxBuffer[2], len-1);
-  return (crc == rxBuffer[len+1]);
-}
-
 struct CrossfireState {
   uint8_t                    module;
   CrossfirePulsesData*       data;
   const etx_serial_driver_t* uart_drv;
   void*                      uart_ctx;
   uint8_t                    endpoint;
+  uint8_t                    rxCrc;  // CRC of the frame being received
 
   void init(uint8_t _module, CrossfirePulsesData* _data,
             const etx_serial_driver_t* _drv, void* _ctx, uint8_t _endpoint)
@@ -134,6 +242,7 @@ struct CrossfireState {
     uart_drv = _drv;
     uart_ctx = _ctx;
     endpoint = _endpoint;
+    rxCrc = 0;
   }
   
   void deinit() { uart_drv->deinit(uart_ctx); }
@@ -174,6 +283,20 @@ static int crossfireGetByte(void* context, uint8_t* data)
   }
 }
 
+static int crossfireGetBytes(void* context, uint8_t* data, uint32_t len)
+{
+  auto state = (CrossfireState*)context;
+  if (state->uart_drv && state->uart_drv->getBytes) {
+    return state->uart_drv->getBytes(state->uart_ctx, data, len);
+  }
+
+  uint32_t count = 0;
+  while (count < len && crossfireGetByte(context, &data[count]) > 0) {
+    count++;
+  }
+  return count;
+}
+
 static bool _lenIsSane(uint8_t len)
 {
   // packet len must be at least 3 bytes (type+payload+crc) and 2 bytes < MAX (hdr+len)
@@ -209,8 +332,18 @@ static void _seekStart(uint8_t* buffer, uint8_t* len)
   *len = 0;
 }
 
+// CRC of the type + payload bytes received so far, the CRC byte excluded
+static uint8_t _frameCRC(uint8_t* buffer, uint8_t len)
+{
+  if (len <= 2) return 0;
+  uint8_t end = min<uint8_t>(len, buffer[1] + 1);
+  return crc8(&buffer[2], end - 2);
+}
+
 static void crossfireProcessData(void* context, uint8_t data, uint8_t* buffer, uint8_t* len)
 {
+  auto state = (CrossfireState*)context;
+
   if (*len == 0 && data != RADIO_ADDRESS && data != UART_SYNC) {
     TRACE("[XF] address 0x%02X error", data);
     return;
@@ -224,6 +357,10 @@ static void crossfireProcessData(void* context, uint8_t data, uint8_t* buffer, u
 
   if (*len < TELEMETRY_RX_PACKET_SIZE) {
     buffer[(*len)++] = data;
+    if (*len <= 2)
+      state->rxCrc = 0;
+    else if (*len < buffer[1] + 2)
+      state->rxCrc = crc8_update(state->rxCrc, data);
   }
   else {
     TRACE("[XF] array size %d error", *len);
@@ -233,20 +370,20 @@ static void crossfireProcessData(void* context, uint8_t data, uint8_t* buffer, u
   // rxBuffer[1] holds the packet length-2, check if the whole packet was received
   while (*len > 4 && (buffer[1]+2) == *len) {
     // TODO: module in context?
-    if (_checkFrameCRC(buffer)) {
+    if (state->rxCrc == buffer[*len - 1]) {
 #if defined(BLUETOOTH)
       if (g_eeGeneral.bluetoothMode == BLUETOOTH_TELEMETRY &&
           bluetooth.state == BLUETOOTH_STATE_CONNECTED) {
         bluetooth.write(buffer, *len);
       }
 #endif
-      auto state = (CrossfireState*)context;
       processCrossfireTelemetryFrame(state->module);
       *len = 0;
     }
     else {
       TRACE("[XF] CRC error ");
       _seekStart(buffer, len); // adjusts len
+      state->rxCrc = _frameCRC(buffer, *len);
     }
   }
 }
@@ -291,6 +428,7 @@ etx_module_driver_t CrossfireInternalDriver = {
   .sendPulses = crossfireSendPulses,
   .getByte = crossfireGetByte,
   .processData = crossfireProcessData,
+  .getBytes = crossfireGetBytes,
 };
 #endif
 
@@ -331,4 +469,5 @@ etx_module_driver_t CrossfireExternalDriver = {
   .sendPulses = crossfireSendPulses,
   .getByte = crossfireGetByte,
   .processData = crossfireProcessData,
+  .getBytes = crossfireGetBytes,
 };
@@ -437,7 +437,8 @@ bool setupPulsesInternalModule(uint8_t protocol)
 {
   uint8_t channelStart = g_model.moduleData[INTERNAL_MODULE].channelsStart;
   int16_t* channels = &channelOutputs[channelStart];
-  uint8_t nChannels = 16;  // TODO: MAX_CHANNELS - channelsStart
+  uint8_t nChannels = min<int>(sentModuleChannels(INTERNAL_MODULE),
+                               MAX_OUTPUT_CHANNELS - channelStart);
 
   if (internalModuleDriver) {
     internalModuleDriver->setupPulses(internalModuleContext,
@@ -649,7 +650,8 @@ bool setupPulsesExternalModule(uint8_t protocol)
 {
   uint8_t channelStart = g_model.moduleData[EXTERNAL_MODULE].channelsStart;
   int16_t* channels = &channelOutputs[channelStart];
-  uint8_t nChannels = 16;  // TODO: MAX_CHANNELS - channelsStart
+  uint8_t nChannels = min<int>(sentModuleChannels(EXTERNAL_MODULE),
+                               MAX_OUTPUT_CHANNELS - channelStart);
 
   if (externalModuleDriver) {
     externalModuleDriver->setupPulses(externalModuleContext,
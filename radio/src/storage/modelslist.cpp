@@ -36,6 +36,7 @@ using std::list;
 #endif
 
 #include <cstring>
+#include <unordered_set>
 
 #include "datastructs.h"
 #include "myeeprom.h"
@@ -979,6 +980,27 @@ char *fileInfoToHexStr(char buffer[17], VfsFileInfo& fInfo)
   return buffer;
 }
 
+void ModelsList::clearFileHash()
+{
+  fileHashInfo.clear();
+  fileHashIndex.clear();
+}
+
+void ModelsList::indexFileHash()
+{
+  fileHashIndex.clear();
+  fileHashIndex.reserve(fileHashInfo.size());
+  for (size_t i = 0; i < fileHashInfo.size(); i++) {
+    fileHashIndex.emplace(fileHashInfo[i].name, i);
+  }
+}
+
+ModelsList::filedat *ModelsList::findFileHash(const std::string &name)
+{
+  auto it = fileHashIndex.find(name);
+  return it != fileHashIndex.end() ? &fileHashInfo[it->second] : nullptr;
+}
+
 /**
  * @brief Loads the Labels and Models from the labels.yml file
  *
@@ -991,7 +1013,7 @@ bool ModelsList::loadYaml()
   // Clear labels + map
   modelslist.clear();
   modelslabels.clear();
-  fileHashInfo.clear();
+  clearFileHash();
 
   DEBUG_TIMER_START(debugTimerYamlScan);
 
@@ -1042,6 +1064,7 @@ bool ModelsList::loadYaml()
     }
     moddir.close();
   }
+  indexFileHash();
 
   // Check if models.yml exists
   // Any files found above that are not listed in the file will be moved into
@@ -1084,17 +1107,10 @@ bool ModelsList::loadYaml()
     file.close();
 
     // Loop through file hases, move any files found that don't exists to /unused
+    std::unordered_set<std::string> listedFiles(modfiles.begin(), modfiles.end());
     std::vector<filedat> newFileHash;
     for(const auto &fhas: fileHashInfo) {
-      bool found = false;
-      for(const auto &file : modfiles) {
-        if (file == fhas.name) {
-          TRACE_LABELS("Found file %s in models.yml.. OK!", file);
-          found = true;
-          break;
-        }
-      }
-      if(!found) {
+      if(listedFiles.count(fhas.name) == 0) {
         moveRequired = true;
         TRACE_LABELS("Model %s not in models.yml, moving to /UNUSED", fhas.name.c_str());
         // Move model into unused folder.
@@ -1102,6 +1118,7 @@ bool ModelsList::loadYaml()
         if(warning)
           POPUP_WARNING(warning);
       } else {
+        TRACE_LABELS("Found file %s in models.yml.. OK!", fhas.name.c_str());
         newFileHash.push_back(fhas); // File exists, keep it
       }
     }
@@ -1118,6 +1135,7 @@ bool ModelsList::loadYaml()
     }
     if(moveRequired) {
       fileHashInfo = newFileHash; // Update the new file list
+      indexFileHash();
       POPUP_WARNING(TR_MODELS_MOVED "\n" UNUSED_MODELS_PATH, "\n" TR_PRESS_ANY_KEY_TO_SKIP);
     }
   }
@@ -1176,7 +1194,7 @@ bool ModelsList::loadYaml()
     }
   }
 
-  fileHashInfo.clear();
+  clearFileHash();
 
   // If any items differed save the file
   if (updatelabelsyml == true) {
@@ -31,6 +31,7 @@
 #include <set>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include "VirtualFS.h"
@@ -266,9 +267,15 @@ class ModelsList : public ModelsVector
   } filedat;
   std::vector<filedat> fileHashInfo;
 
+  // Files found in the models folder, hashed by file name
+  filedat *findFileHash(const std::string &name);
+
  protected:
   VfsFile file;
+  std::unordered_map<std::string, size_t> fileHashIndex;
 
+  void clearFileHash();
+  void indexFileHash();
   bool loadTxt();
 #if defined(SDCARD_YAML)
   bool loadYaml();
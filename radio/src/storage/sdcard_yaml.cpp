@@ -26,6 +26,7 @@
 #include "sdcard_raw.h"
 #include "sdcard_yaml.h"
 #include "modelslist.h"
+#include "fw_version.h"
 #include "VirtualFS.h"
 
 #include "yaml/yaml_tree_walker.h"
@@ -342,6 +343,155 @@ const char * writeGeneralSettings()
 }
 
 
+#if defined(MODEL_CACHE)
+// The models read from YAML are also saved as binary images in
+// MODELS_CACHE_PATH. An image is only used as long as the size and date of
+// its YAML file have not changed, and it has been written by the same
+// firmware build: YAML stores sources and switches by name, the image
+// keeps the MIXSRC_/SWSRC_ numbers they resolved to in that build.
+
+#define MODEL_CACHE_MAGIC     "EMCH"
+#define MODEL_CACHE_VERSION   2
+#define MODEL_CACHE_FIRMWARE  VERSION " " GIT_STR " " DATE " " TIME
+
+PACK(struct ModelCacheHeader {
+  char     magic[4];
+  uint8_t  version;
+  uint32_t schema;       // hash of the YAML nodes
+  uint32_t firmware;     // hash of MODEL_CACHE_FIRMWARE
+  uint32_t dataSize;
+  uint32_t yamlSize;
+  uint16_t yamlDate;
+  uint16_t yamlTime;
+  uint16_t checksum;     // CRC of the image
+});
+
+static uint32_t hashYamlNodes(const YamlNode* node, uint32_t hash)
+{
+  for (; node->type != YDT_NONE; node++) {
+    hash = (hash ^ node->type) * 16777619u;
+    hash = (hash ^ node->size) * 16777619u;
+    for (uint8_t i = 0; i < node->tag_len; i++) {
+      hash = (hash ^ (uint8_t)node->tag[i]) * 16777619u;
+    }
+    if (node->type == YDT_ARRAY) {
+      hash = (hash ^ node->u._array.u._a.elmts) * 16777619u;
+      hash = hashYamlNodes(node->u._array.child, hash);
+    }
+    else if (node->type == YDT_UNION) {
+      hash = hashYamlNodes(node->u._array.child, hash);
+    }
+  }
+  return hash;
+}
+
+static uint32_t getModelCacheSchema()
+{
+  static uint32_t schema = 0;
+  if (!schema) {
+    schema = hashYamlNodes(get_modeldata_nodes()->u._array.child, 2166136261u);
+  }
+  return schema;
+}
+
+static uint32_t getModelCacheFirmware()
+{
+  uint32_t hash = 2166136261u;
+  for (const char* c = MODEL_CACHE_FIRMWARE; *c; c++) {
+    hash = (hash ^ (uint8_t)*c) * 16777619u;
+  }
+  return hash;
+}
+
+static void getModelCachePath(char* path, const char* filename)
+{
+  getModelPath(path, filename, MODELS_CACHE_PATH);
+  char* ext = strrchr(path, '.');
+  if (ext) *ext = '\0';
+  strcat(path, MODELS_CACHE_EXT);
+}
+
+// Fills the header the cache of a YAML file must have
+static bool getModelCacheHeader(const char* yamlPath, ModelCacheHeader& header)
+{
+  VfsFileInfo info;
+  if (VirtualFS::instance().fstat(yamlPath, info) != VfsError::OK)
+    return false;
+
+  memcpy(header.magic, MODEL_CACHE_MAGIC, sizeof(header.magic));
+  header.version = MODEL_CACHE_VERSION;
+  header.schema = getModelCacheSchema();
+  header.firmware = getModelCacheFirmware();
+  header.dataSize = sizeof(ModelData);
+  header.yamlSize = info.getSize();
+  header.yamlDate = info.getDate();
+  header.yamlTime = info.getTime();
+  header.checksum = 0;
+  return true;
+}
+
+// Reads the first size bytes of the cached image, the CRC being checked
+// on the whole image
+static bool readModelCache(const char* filename, const ModelCacheHeader& expected, uint8_t* buffer, uint32_t size)
+{
+  char path[256];
+  getModelCachePath(path, filename);
+
+  VfsFile file;
+  if (VirtualFS::instance().openFile(file, path, VfsOpenFlags::OPEN_EXISTING | VfsOpenFlags::READ) != VfsError::OK)
+    return false;
+
+  ModelCacheHeader header;
+  size_t read = 0;
+  bool valid = (file.read(&header, sizeof(header), read) == VfsError::OK && read == sizeof(header) &&
+                !memcmp(&header, &expected, offsetof(ModelCacheHeader, checksum)) &&
+                file.read(buffer, size, read) == VfsError::OK && read == size);
+
+  uint16_t checksum = crc16(0, buffer, size, 0xFFFF);
+  uint8_t chunk[64];
+  for (uint32_t done = size; valid && done < sizeof(ModelData); done += read) {
+    valid = (file.read(chunk, min<uint32_t>(sizeof(chunk), sizeof(ModelData) - done), read) == VfsError::OK && read > 0);
+    checksum = crc16(0, chunk, read, checksum);
+  }
+  file.close();
+
+  return valid && checksum == header.checksum;
+}
+
+static void writeModelCache(const char* filename, ModelCacheHeader& header, const uint8_t* data)
+{
+  VirtualFS& vfs = VirtualFS::instance();
+  if (vfs.checkAndCreateDirectory(MODELS_CACHE_PATH))
+    return;
+
+  char path[256];
+  getModelCachePath(path, filename);
+
+  VfsFile file;
+  if (vfs.openFile(file, path, VfsOpenFlags::CREATE_ALWAYS | VfsOpenFlags::WRITE) != VfsError::OK)
+    return;
+
+  header.checksum = crc16(0, data, sizeof(ModelData), 0xFFFF);
+  size_t written = 0;
+  bool ok = (file.write(&header, sizeof(header), written) == VfsError::OK && written == sizeof(header) &&
+             file.write(data, sizeof(ModelData), written) == VfsError::OK && written == sizeof(ModelData));
+  file.close();
+
+  if (!ok) {
+    vfs.unlink(path);
+  }
+}
+
+// Needed even though the YAML file date changes: radios without RTC
+// may write it with the same date
+static void invalidateModelCache(const char* filename)
+{
+  char path[256];
+  getModelCachePath(path, filename);
+  VirtualFS::instance().unlink(path);
+}
+#endif
+
 const char * readModelYaml(const char * filename, uint8_t * buffer, uint32_t size, const char* pathName)
 {
     // YAML reader
@@ -364,6 +514,15 @@ const char * readModelYaml(const char * filename, uint8_t * buffer, uint32_t siz
     char path[256];
     getModelPath(path, filename, pathName);
 
+#if defined(MODEL_CACHE)
+    ModelCacheHeader cacheHeader;
+    bool cached = !strcmp(pathName, STR_MODELS_PATH) && getModelCacheHeader(path, cacheHeader);
+    if (cached && readModelCache(filename, cacheHeader, buffer, size)) {
+      TRACE("YAML model read from cache");
+      return nullptr;
+    }
+#endif
+
     YamlTreeWalker tree;
     tree.reset(data_nodes, buffer);
 
@@ -388,7 +547,15 @@ const char * readModelYaml(const char * filename, uint8_t * buffer, uint32_t siz
       // md->swashR.elevatorWeight   = 100;
     }
 
-    return readYamlFile(path, YamlTreeWalker::get_parser_calls(), &tree, NULL);
+    const char* error = readYamlFile(path, YamlTreeWalker::get_parser_calls(), &tree, NULL);
+
+#if defined(MODEL_CACHE)
+    if (!error && cached && init_model) {
+      writeModelCache(filename, cacheHeader, buffer);
+    }
+#endif
+
+    return error;
 }
 
 static const char _wrongExtentionError[] = "wrong file extension";
@@ -408,6 +575,9 @@ const char * writeModelYaml(const char* filename)
     TRACE("YAML model writer");
     char path[256];
     getModelPath(path, filename);
+#if defined(MODEL_CACHE)
+    invalidateModelCache(filename);
+#endif
     return writeFileYaml(path, get_modeldata_nodes(), (uint8_t*)&g_model,0 );
 }
 
@@ -547,6 +717,9 @@ int8_t deleteModel(uint8_t idx)
   if (VirtualFS::instance().unlink(fname) != VfsError::OK) {
     return -1;
   }
+#if defined(MODEL_CACHE)
+  invalidateModelCache(model_idx);
+#endif
 
   modelHeaders[idx].name[0] = '\0';
   return 0;
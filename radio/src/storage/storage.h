@@ -36,6 +36,14 @@ extern uint8_t   storageDirtyMsk;
 extern tmr10ms_t storageDirtyTime10ms;
 #define TIME_TO_WRITE()                (storageDirtyMsk && (tmr10ms_t)(get_tmr10ms() - storageDirtyTime10ms) >= (tmr10ms_t)WRITE_DELAY_10MS)
 
+// Bumped each time the current model is modified or (re)loaded, so that
+// data derived from g_model (mixer plan, ...) can tell when it is stale
+extern volatile uint32_t modelDataRevision;
+
+// GVAR values may change at every mixer run (special functions, trims,
+// Lua): they bump this one instead, see storageDirtyGVars()
+extern volatile uint32_t gvarsRevision;
+
 #if defined(RTC_BACKUP_RAM)
 #include "storage/rtc_backup.h"
 extern uint8_t   rambackupDirtyMsk;
@@ -55,6 +63,7 @@ void storageCheck(bool immediately);
 // Generic storage functions (implemented in storage_common.cpp)
 //
 void storageDirty(uint8_t msk);
+void storageDirtyGVars();
 void storageFlushCurrentModel();
 void postRadioSettingsLoad();
 void preModelLoad();
@@ -32,13 +32,15 @@
 
 uint8_t   storageDirtyMsk;
 tmr10ms_t storageDirtyTime10ms;
+volatile uint32_t modelDataRevision;
+volatile uint32_t gvarsRevision;
 
 #if defined(RTC_BACKUP_RAM)
 uint8_t   rambackupDirtyMsk = EE_GENERAL | EE_MODEL;
 tmr10ms_t rambackupDirtyTime10ms;
 #endif
 
-void storageDirty(uint8_t msk)
+static void setStorageDirty(uint8_t msk)
 {
   storageDirtyMsk |= msk;
   storageDirtyTime10ms = get_tmr10ms();
@@ -49,6 +51,21 @@ void storageDirty(uint8_t msk)
 #endif
 }
 
+void storageDirty(uint8_t msk)
+{
+  if (msk & EE_MODEL) {
+    modelDataRevision++;
+  }
+
+  setStorageDirty(msk);
+}
+
+void storageDirtyGVars()
+{
+  gvarsRevision++;
+  setStorageDirty(EE_MODEL);
+}
+
 void preModelLoad()
 {
   watchdogSuspend(500/*5s*/);
@@ -109,6 +126,8 @@ void postRadioSettingsLoad()
 
 void postModelLoad(bool alarms)
 {
+  modelDataRevision++;
+
 #if defined(PXX2)
   if (is_memclear(g_model.modelRegistrationID, PXX2_LEN_REGISTRATION_ID)) {
     memcpy(g_model.modelRegistrationID, g_eeGeneral.ownerRegistrationID, PXX2_LEN_REGISTRATION_ID);
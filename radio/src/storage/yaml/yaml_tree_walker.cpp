@@ -257,9 +257,26 @@ bool YamlTreeWalker::findNode(const char* tag, uint8_t tag_len)
     if (virt_level)
         return false;
 
+    const struct YamlNode* attr = nullptr;
+
+    // Keys are mostly in the order of the attributes, as this is how they
+    // are written: look first from the current attribute onwards, which
+    // finds the next key right away instead of scanning the whole node.
+    if (!isArrayElmt()) {
+        attr = getAttr();
+        while(attr && attr->type != YDT_NONE) {
+            if ((tag_len == attr->tag_len)
+                && !strncmp(tag, attr->tag, tag_len)) {
+                return true; // attribute found!
+            }
+            toNextAttr();
+            attr = getAttr();
+        }
+    }
+
     rewind();
 
-    const struct YamlNode* attr = getAttr();
+    attr = getAttr();
     if (isArrayElmt() && attr && attr->type == YDT_IDX) {
         setAttrValue((char*)tag, tag_len);
         return true;
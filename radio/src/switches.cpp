@@ -621,12 +621,179 @@ bool getSwitch(swsrc_t swtch, uint8_t flags)
   return swtch > 0 ? result : !result;
 }
 
+// The logical switches are sorted each time the model changes (see
+// modelDataRevision), so that a logical switch used by another one (as AND
+// switch, boolean operand or source) is always computed first: the result of
+// a chain is then known in the same tick, whatever the position of its
+// switches in the list. Unused logical switches are skipped, once they are
+// off. Switches belonging to a loop (L1 uses L2 which uses L1) cannot be
+// sorted, they read the state of the previous tick. The model revision also
+// changes with edits unrelated to the logical switches, so the contexts
+// (delays, durations, sticky and edge states) are only reset for the switches
+// which were actually edited. GVAR values don't change the model revision
+// (see gvarsRevision) and don't need to: the plan only holds the order and
+// CRC of LogicalSwitchData, the GVARs are read when the switches are computed.
+
+#if MAX_LOGICAL_SWITCHES > 64
+#error "The logical switches plan assumes that MAX_LOGICAL_SWITCHES <= 64!"
+#endif
+
+typedef uint64_t bitfield_logical_switches_t;
+
+struct LogicalSwitchesPlan {
+  bool valid;
+  uint32_t revision;
+  uint8_t count;
+  uint8_t order[MAX_LOGICAL_SWITCHES];
+  uint16_t crc[MAX_LOGICAL_SWITCHES]; // to detect the edited switches
+};
+
+static LogicalSwitchesPlan lswPlan;
+
+static bitfield_logical_switches_t getLogicalSwitchMask(int16_t swtch)
+{
+  swtch = abs(swtch);
+  if (swtch >= SWSRC_FIRST_LOGICAL_SWITCH && swtch <= SWSRC_LAST_LOGICAL_SWITCH)
+    return (bitfield_logical_switches_t)1 << (swtch - SWSRC_FIRST_LOGICAL_SWITCH);
+  return 0;
+}
+
+static bitfield_logical_switches_t getLogicalSwitchSourceMask(int16_t source)
+{
+  source = abs(source);
+  if (source >= MIXSRC_FIRST_LOGICAL_SWITCH && source <= MIXSRC_LAST_LOGICAL_SWITCH)
+    return (bitfield_logical_switches_t)1 << (source - MIXSRC_FIRST_LOGICAL_SWITCH);
+  return 0;
+}
+
+static void compileLogicalSwitchesPlan()
+{
+  uint32_t revision = modelDataRevision;
+  bitfield_logical_switches_t used = 0;
+  bitfield_logical_switches_t off = 0;
+  bitfield_logical_switches_t deps[MAX_LOGICAL_SWITCHES];
+
+  for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+    LogicalSwitchData * ls = lswAddress(i);
+    deps[i] = 0;
+
+    uint16_t crc = crc16(CRC_1021, (const uint8_t *)ls, sizeof(LogicalSwitchData));
+    if (crc != lswPlan.crc[i]) {
+      lswPlan.crc[i] = crc;
+      // the state is kept, so that the ON / OFF sounds are played
+      for (uint8_t fm = 0; fm < MAX_FLIGHT_MODES; fm++) {
+        LogicalSwitchContext & context = lswFm[fm].lsw[i];
+        context.timerState = SWITCH_START;
+        context.timer = 0;
+        context.lastValue = CS_LAST_VALUE_INIT;
+      }
+    }
+
+    if (ls->func == LS_FUNC_NONE) {
+      // still evaluated until it is off in every flight mode
+      for (uint8_t fm = 0; fm < MAX_FLIGHT_MODES; fm++) {
+        if (lswFm[fm].lsw[i].state)
+          off |= (bitfield_logical_switches_t)1 << i;
+      }
+      continue;
+    }
+
+    used |= (bitfield_logical_switches_t)1 << i;
+    deps[i] = getLogicalSwitchMask(ls->andsw);
+
+    switch (lswFamily(ls->func)) {
+      case LS_FAMILY_BOOL:
+      case LS_FAMILY_STICKY:
+        deps[i] |= getLogicalSwitchMask(ls->v1) | getLogicalSwitchMask(ls->v2);
+        break;
+      case LS_FAMILY_EDGE:
+        deps[i] |= getLogicalSwitchMask(ls->v1);
+        break;
+      case LS_FAMILY_COMP:
+        deps[i] |= getLogicalSwitchSourceMask(ls->v1) | getLogicalSwitchSourceMask(ls->v2);
+        break;
+      case LS_FAMILY_OFS:
+      case LS_FAMILY_DIFF:
+        deps[i] |= getLogicalSwitchSourceMask(ls->v1);
+        break;
+    }
+
+    deps[i] &= ~((bitfield_logical_switches_t)1 << i);
+  }
+
+  // unused logical switches are always false
+  for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+    deps[i] &= used;
+  }
+
+  // logical switches which can reach themselves through their inputs
+  bitfield_logical_switches_t loops = 0;
+  for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+    bitfield_logical_switches_t reach = deps[i];
+    bitfield_logical_switches_t visited = 0;
+    while (reach & ~visited) {
+      bitfield_logical_switches_t next = reach & ~visited;
+      visited |= next;
+      for (uint8_t src = 0; src < MAX_LOGICAL_SWITCHES; src++) {
+        if (next & ((bitfield_logical_switches_t)1 << src))
+          reach |= deps[src];
+      }
+    }
+    if (reach & ((bitfield_logical_switches_t)1 << i))
+      loops |= (bitfield_logical_switches_t)1 << i;
+  }
+
+  // order the logical switches: lowest one whose inputs are all computed
+  // first, and when only loops are left, break the lowest one
+  uint8_t count = 0;
+  bitfield_logical_switches_t done = ~used;
+  while (~done) {
+    int8_t next = -1;
+    for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES && next < 0; i++) {
+      bitfield_logical_switches_t mask = (bitfield_logical_switches_t)1 << i;
+      if (!(done & mask) && !(deps[i] & ~done))
+        next = i;
+    }
+    for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES && next < 0; i++) {
+      bitfield_logical_switches_t mask = (bitfield_logical_switches_t)1 << i;
+      if (!(done & mask) && (loops & mask))
+        next = i;
+    }
+    for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES && next < 0; i++) {
+      if (!(done & ((bitfield_logical_switches_t)1 << i)))
+        next = i;
+    }
+    lswPlan.order[count++] = next;
+    done |= (bitfield_logical_switches_t)1 << next;
+  }
+
+  // unused switches don't depend on anything
+  for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+    if (off & ((bitfield_logical_switches_t)1 << i))
+      lswPlan.order[count++] = i;
+  }
+
+  lswPlan.count = count;
+  lswPlan.revision = revision;
+  lswPlan.valid = true;
+}
+
+static inline void checkLogicalSwitchesPlan()
+{
+  if (lswPlan.valid && lswPlan.revision == modelDataRevision)
+    return;
+  compileLogicalSwitchesPlan();
+}
+
 /**
   @brief Calculates new state of logical switches for mixerCurrentFlightMode
 */
 void evalLogicalSwitches(bool isCurrentFlightmode)
 {
-  for (unsigned int idx=0; idx<MAX_LOGICAL_SWITCHES; idx++) {
+  checkLogicalSwitchesPlan();
+
+  for (uint8_t o = 0; o < lswPlan.count; o++) {
+    uint8_t idx = lswPlan.order[o];
     LogicalSwitchContext & context = lswFm[mixerCurrentFlightMode].lsw[idx];
     bool result = getLogicalSwitch(idx);
     if (isCurrentFlightmode) {
@@ -714,7 +881,10 @@ bool isSwitchWarningRequired(uint16_t &bad_pots)
   }
 
   if (g_model.potsWarnMode) {
+    // called from the UI task, the mixer caches must not change under it
+    pauseMixerCalculations();
     evalFlightModeMixes(e_perout_mode_normal, 0);
+    resumeMixerCalculations();
     bad_pots = 0;
     for (int  i = 0; i < NUM_POTS + NUM_SLIDERS; i++) {
       if (!IS_POT_SLIDER_AVAILABLE(POT1 + i)) {
@@ -899,8 +1069,10 @@ void logicalSwitchesTimerTick()
   }
 
   // Update logical switches
+  checkLogicalSwitchesPlan();
   for (uint8_t fm=0; fm<MAX_FLIGHT_MODES; fm++) {
-    for (uint8_t i=0; i<MAX_LOGICAL_SWITCHES; i++) {
+    for (uint8_t o=0; o<lswPlan.count; o++) {
+      uint8_t i = lswPlan.order[o];
       LogicalSwitchData * ls = lswAddress(i);
       if (ls->func == LS_FUNC_TIMER) {
         int16_t * lastValue = &LS_LAST_VALUE(fm, i);
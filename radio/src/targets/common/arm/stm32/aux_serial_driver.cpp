@@ -175,6 +175,7 @@ const etx_serial_driver_t AuxSerialDriver = {
   .sendBuffer = aux_serial_send_buffer,
   .waitForTxCompleted = aux_wait_tx_completed,
   .getByte = aux_get_byte,
+  .getBytes = nullptr,
   .getBaudrate = nullptr,
   .setReceiveCb = aux1SetRxCb,
   .setBaudrateCb = nullptr,
@@ -269,6 +270,7 @@ const etx_serial_driver_t Aux2SerialDriver = {
   .sendBuffer = aux_serial_send_buffer,
   .waitForTxCompleted = aux_wait_tx_completed,
   .getByte = aux_get_byte,
+  .getBytes = nullptr,
   .getBaudrate = nullptr,
   .setReceiveCb = aux2SetRxCb,
   .setBaudrateCb = nullptr,
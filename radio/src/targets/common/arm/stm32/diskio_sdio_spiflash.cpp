@@ -29,6 +29,10 @@
 #include "debug.h"
 #include "targets/common/arm/stm32/sdio_sd.h"
 
+#if defined(DISK_CACHE) && !defined(BOOT)
+  #include "disk_cache.h"
+#endif
+
 #include <string.h>
 
 // TODO share this with Horus (and perhaps other STM32)
@@ -68,6 +72,36 @@ int ff_del_syncobj (FF_SYNC_t mutex)
 {
   return 1;
 }
+
+#if defined(DISK_CACHE_WRITEBACK)
+void diskCacheCheckTimeout()
+{
+  if (!initialized)
+    return;
+  RTOS_LOCK_MUTEX(ioMutex);
+  diskCache[0].checkTimeout(0);
+  RTOS_UNLOCK_MUTEX(ioMutex);
+}
+
+void diskCacheSuspend()
+{
+  if (!initialized)
+    return;
+  RTOS_LOCK_MUTEX(ioMutex);
+  diskCache[0].setWriteBack(0, false);
+  RTOS_UNLOCK_MUTEX(ioMutex);
+}
+
+void diskCacheResume()
+{
+  if (!initialized)
+    return;
+  RTOS_LOCK_MUTEX(ioMutex);
+  diskCache[0].clear();
+  diskCache[0].setWriteBack(0, true);
+  RTOS_UNLOCK_MUTEX(ioMutex);
+}
+#endif
 #endif
 #if defined(SPI_FLASH)
 #include "tjftl/tjftl.h"
@@ -460,8 +494,12 @@ DRESULT disk_ioctl (
       break;
 
     case CTRL_SYNC:
-      while (SD_GetStatus() == SD_TRANSFER_BUSY); /* Complete pending write process (needed at _FS_READONLY == 0) */
+#if defined(DISK_CACHE) && !defined(BOOT)
+      res = diskCache[0].flush(0);
+#else
       res = RES_OK;
+#endif
+      while (SD_GetStatus() == SD_TRANSFER_BUSY); /* Complete pending write process (needed at _FS_READONLY == 0) */
       break;
 
     default:
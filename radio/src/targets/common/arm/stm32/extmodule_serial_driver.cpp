@@ -138,6 +138,13 @@ static int extmoduleGetByte(void* ctx, uint8_t* data)
   return modCtx->rxFifo->pop(*data);
 }
 
+static int extmoduleGetBytes(void* ctx, uint8_t* data, uint32_t len)
+{
+  auto modCtx = (ExtmoduleCtx*)ctx;
+  if (!modCtx->rxFifo) return -1;
+  return modCtx->rxFifo->pop(data, len);
+}
+
 static void extmoduleClearRxBuffer(void* ctx)
 {
   auto modCtx = (ExtmoduleCtx*)ctx;
@@ -152,6 +159,7 @@ const etx_serial_driver_t ExtmoduleSerialDriver = {
   .sendBuffer = extmoduleSendBuffer,
   .waitForTxCompleted = extmoduleWaitForTxCompleted,
   .getByte = extmoduleGetByte,
+  .getBytes = extmoduleGetBytes,
   .clearRxBuffer = extmoduleClearRxBuffer,
   .getBaudrate = nullptr,
   .setReceiveCb = nullptr,
@@ -198,6 +198,13 @@ static int intmoduleGetByte(void* ctx, uint8_t* data)
   return modCtx->rxFifo->pop(*data);
 }
 
+static int intmoduleGetBytes(void* ctx, uint8_t* data, uint32_t len)
+{
+  auto modCtx = (IntmoduleCtx*)ctx;
+  if (!modCtx->rxFifo) return -1;
+  return modCtx->rxFifo->pop(data, len);
+}
+
 static void intmoduleClearRxBuffer(void* ctx)
 {
   auto modCtx = (IntmoduleCtx*)ctx;
@@ -212,6 +219,7 @@ const etx_serial_driver_t IntmoduleSerialDriver = {
   .sendBuffer = intmoduleSendBuffer,
   .waitForTxCompleted = intmoduleWaitForTxCompleted,
   .getByte = intmoduleGetByte,
+  .getBytes = intmoduleGetBytes,
   .clearRxBuffer = intmoduleClearRxBuffer,
   .getBaudrate = nullptr,
   .setReceiveCb = nullptr,
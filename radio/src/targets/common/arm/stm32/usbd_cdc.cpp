@@ -303,6 +303,7 @@ static const etx_serial_driver_t usbSerialDriver = {
   .sendBuffer = nullptr,
   .waitForTxCompleted = nullptr,
   .getByte = nullptr,
+  .getBytes = nullptr,
   .clearRxBuffer = nullptr,
   .getBaudrate = usbSerialBaudRate,
   .setReceiveCb = usbSerialSetReceiveDataCb,
@@ -31,6 +31,9 @@
 #include "globals.h"
 #include "sdcard.h"
 #include "debug.h"
+#if defined(DISK_CACHE_WRITEBACK) && !defined(BOOT)
+  #include "disk_cache.h"
+#endif
 
 #include <string.h>
 
@@ -261,6 +264,10 @@ void boardInit()
 
 void boardOff()
 {
+#if defined(DISK_CACHE_WRITEBACK) && !defined(BOOT)
+  diskCacheSuspend();
+#endif
+
   backlightEnable(0);
 
   while (pwrPressed()) {
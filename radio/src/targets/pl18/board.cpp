@@ -27,6 +27,9 @@
 #endif
 #include "touch.h"
 #include "debug.h"
+#if defined(DISK_CACHE_WRITEBACK) && !defined(BOOT)
+  #include "disk_cache.h"
+#endif
 
 #include "hal/adc_driver.h"
 #include "stm32_hal_adc.h"
@@ -210,6 +213,10 @@ void boardInit()
 
 void boardOff()
 {
+#if defined(DISK_CACHE_WRITEBACK) && !defined(BOOT)
+  diskCacheSuspend();
+#endif
+
   lcd->drawFilledRect(0, 0, LCD_W, LCD_H, SOLID, COLOR_THEME_FOCUS);
   lcdOff();
 
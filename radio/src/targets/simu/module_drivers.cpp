@@ -74,6 +74,7 @@ const etx_serial_driver_t IntmoduleSerialDriver = {
     .sendBuffer = sendBuffer,
     .waitForTxCompleted = waitForTxCompleted,
     .getByte = getByte,
+    .getBytes = nullptr,
     .clearRxBuffer = nullptr,
     .getBaudrate = nullptr,
     .setReceiveCb = nullptr,
@@ -87,6 +88,7 @@ const etx_serial_driver_t ExtmoduleSerialDriver = {
     .sendBuffer = sendBuffer,
     .waitForTxCompleted = waitForTxCompleted,
     .getByte = getByte,
+    .getBytes = nullptr,
     .clearRxBuffer = nullptr,
     .getBaudrate = nullptr,
     .setReceiveCb = nullptr,
@@ -54,6 +54,15 @@ int ff_del_syncobj (FF_SYNC_t sobj)        /* Delete a sync object */
   return 1;
 }
 
+#if defined(DISK_CACHE_WRITEBACK)
+void diskCacheCheckTimeout()
+{
+  pthread_mutex_lock(&ioMutex);
+  diskCache[0].checkTimeout(0);
+  pthread_mutex_unlock(&ioMutex);
+}
+#endif
+
 DWORD get_fattime (void)
 {
   time_t tim = time(0);
@@ -144,6 +153,11 @@ DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff)
   switch(cmd) {
 /* Generic command (Used by FatFs) */
     case CTRL_SYNC :     /* Complete pending write process (needed at _FS_READONLY == 0) */
+#if defined(DISK_CACHE)
+      res = diskCache[pdrv].flush(pdrv);
+#else
+      res = RES_OK;
+#endif
       break;
 
     case GET_SECTOR_COUNT: /* Get media size (needed at _USE_MKFS == 1) */
@@ -22,6 +22,7 @@
 #include "opentx.h"
 #include "mixer_scheduler.h"
 #include "timers_driver.h"
+#include "logs.h"
 
 RTOS_TASK_HANDLE menusTaskId;
 RTOS_DEFINE_STACK(menusStack, MENUS_STACK_SIZE);
@@ -158,6 +159,9 @@ TASK_FUNCTION(mixerTask)
       doMixerCalculations();
       sendSynchronousPulses((1 << INTERNAL_MODULE) | (1 << EXTERNAL_MODULE));
       doMixerPeriodicUpdates();
+#if defined(SDCARD) && defined(LOG_BINARY)
+      logsSnapshot();
+#endif
 
       DEBUG_TIMER_START(debugTimerMixerCalcToUsage);
       DEBUG_TIMER_SAMPLE(debugTimerMixerIterval);
@@ -61,26 +61,29 @@ const CrossfireSensor crossfireSensors[] = {
 
 const CrossfireSensor & getCrossfireSensor(uint8_t id, uint8_t subId)
 {
-  if (id == LINK_ID)
-    return crossfireSensors[RX_RSSI1_INDEX+subId];
-  else if (id == LINK_RX_ID)
-    return crossfireSensors[RX_RSSI_PERC_INDEX+subId];
-  else if (id == LINK_TX_ID)
-    return crossfireSensors[TX_RSSI_PERC_INDEX+subId];
-  else if (id == BATTERY_ID)
-    return crossfireSensors[BATT_VOLTAGE_INDEX+subId];
-  else if (id == GPS_ID)
-    return crossfireSensors[GPS_LATITUDE_INDEX+subId];
-  else if (id == CF_VARIO_ID)
-    return crossfireSensors[VERTICAL_SPEED_INDEX];
-  else if (id == ATTITUDE_ID)
-    return crossfireSensors[ATTITUDE_PITCH_INDEX+subId];
-  else if (id == FLIGHT_MODE_ID)
-    return crossfireSensors[FLIGHT_MODE_INDEX];
-  else if (id == BARO_ALT_ID)
-    return crossfireSensors[BARO_ALTITUDE_INDEX];
-  else
-    return crossfireSensors[UNKNOWN_INDEX];
+  // dense frame ids, compiled into a jump table
+  switch (id) {
+    case LINK_ID:
+      return crossfireSensors[RX_RSSI1_INDEX+subId];
+    case LINK_RX_ID:
+      return crossfireSensors[RX_RSSI_PERC_INDEX+subId];
+    case LINK_TX_ID:
+      return crossfireSensors[TX_RSSI_PERC_INDEX+subId];
+    case BATTERY_ID:
+      return crossfireSensors[BATT_VOLTAGE_INDEX+subId];
+    case GPS_ID:
+      return crossfireSensors[GPS_LATITUDE_INDEX+subId];
+    case CF_VARIO_ID:
+      return crossfireSensors[VERTICAL_SPEED_INDEX];
+    case ATTITUDE_ID:
+      return crossfireSensors[ATTITUDE_PITCH_INDEX+subId];
+    case FLIGHT_MODE_ID:
+      return crossfireSensors[FLIGHT_MODE_INDEX];
+    case BARO_ALT_ID:
+      return crossfireSensors[BARO_ALTITUDE_INDEX];
+    default:
+      return crossfireSensors[UNKNOWN_INDEX];
+  }
 }
 
 void processCrossfireTelemetryValue(uint8_t index, int32_t value)
@@ -259,10 +262,8 @@ void processCrossfireTelemetryFrame(uint8_t module)
 #if defined(LUA)
     default:
       if (luaInputTelemetryFifo && luaInputTelemetryFifo->hasSpace(rxBufferCount-2) ) {
-        for (uint8_t i=1; i<rxBufferCount-1; i++) {
-          // destination address and CRC are skipped
-          luaInputTelemetryFifo->push(rxBuffer[i]);
-        }
+        // destination address and CRC are skipped
+        luaInputTelemetryFifo->push(&rxBuffer[1], rxBufferCount - 2);
       }
       break;
 #endif
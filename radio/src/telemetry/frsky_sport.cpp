@@ -30,52 +30,52 @@ struct FrSkySportSensor {
   const uint8_t prec;
 };
 
-const FrSkySportSensor sportSensors[] = {
-  { VALID_FRAME_RATE_ID, VALID_FRAME_RATE_ID, 0, STR_VFR, UNIT_PERCENT, 0 },
-  { RSSI_ID, RSSI_ID, 0, STR_SENSOR_RSSI, UNIT_DB, 0 },
-#if defined(MULTIMODULE)
-  { TX_RSSI_ID, TX_RSSI_ID, 0, STR_SENSOR_TX_RSSI   , UNIT_DB , 0 },
-  { TX_LQI_ID , TX_LQI_ID,  0, STR_SENSOR_TX_QUALITY, UNIT_RAW, 0 },
-#endif
-  { ADC1_ID, ADC1_ID, 0, STR_SENSOR_A1, UNIT_VOLTS, 1 },
-  { ADC2_ID, ADC2_ID, 0, STR_SENSOR_A2, UNIT_VOLTS, 1 },
-  { A3_FIRST_ID, A3_LAST_ID, 0, STR_SENSOR_A3, UNIT_VOLTS, 2 },
-  { A4_FIRST_ID, A4_LAST_ID, 0, STR_SENSOR_A4, UNIT_VOLTS, 2 },
-  { BATT_ID, BATT_ID, 0, STR_SENSOR_BATT, UNIT_VOLTS, 1 },
-  { R9_PWR_ID, R9_PWR_ID, 0, STR_SENSOR_R9PW, UNIT_MILLIWATTS, 0 },
+// Sorted on firstId then subId, getFrSkySportSensor() does a binary search
+constexpr FrSkySportSensor sportSensors[] = {
+  { ALT_FIRST_ID, ALT_LAST_ID, 0, STR_SENSOR_ALT, UNIT_METERS, 2 },
+  { VARIO_FIRST_ID, VARIO_LAST_ID, 0, STR_SENSOR_VSPD, UNIT_METERS_PER_SECOND, 2 },
+  { CURR_FIRST_ID, CURR_LAST_ID, 0, STR_SENSOR_CURR, UNIT_AMPS, 1 },
+  { VFAS_FIRST_ID, VFAS_LAST_ID, 0, STR_SENSOR_VFAS, UNIT_VOLTS, 2 },
+  { CELLS_FIRST_ID, CELLS_LAST_ID, 0, STR_SENSOR_CELLS, UNIT_CELLS, 2 },
   { T1_FIRST_ID, T1_LAST_ID, 0, STR_SENSOR_TEMP1, UNIT_CELSIUS, 0 },
   { T2_FIRST_ID, T2_LAST_ID, 0, STR_SENSOR_TEMP2, UNIT_CELSIUS, 0 },
   { RPM_FIRST_ID, RPM_LAST_ID, 0, STR_SENSOR_RPM, UNIT_RPMS, 0 },
   { FUEL_FIRST_ID, FUEL_LAST_ID, 0, STR_SENSOR_FUEL, UNIT_PERCENT, 0 },
-  { ALT_FIRST_ID, ALT_LAST_ID, 0, STR_SENSOR_ALT, UNIT_METERS, 2 },
-  { VARIO_FIRST_ID, VARIO_LAST_ID, 0, STR_SENSOR_VSPD, UNIT_METERS_PER_SECOND, 2 },
   { ACCX_FIRST_ID, ACCX_LAST_ID, 0, STR_SENSOR_ACCX, UNIT_G, 3 },
   { ACCY_FIRST_ID, ACCY_LAST_ID, 0, STR_SENSOR_ACCY, UNIT_G, 3 },
   { ACCZ_FIRST_ID, ACCZ_LAST_ID, 0, STR_SENSOR_ACCZ, UNIT_G, 3 },
-  { CURR_FIRST_ID, CURR_LAST_ID, 0, STR_SENSOR_CURR, UNIT_AMPS, 1 },
-  { VFAS_FIRST_ID, VFAS_LAST_ID, 0, STR_SENSOR_VFAS, UNIT_VOLTS, 2 },
-  { AIR_SPEED_FIRST_ID, AIR_SPEED_LAST_ID, 0, STR_SENSOR_ASPD, UNIT_KTS, 1 },
-  { GPS_SPEED_FIRST_ID, GPS_SPEED_LAST_ID, 0, STR_SENSOR_GSPD, UNIT_KTS, 3 },
-  { CELLS_FIRST_ID, CELLS_LAST_ID, 0, STR_SENSOR_CELLS, UNIT_CELLS, 2 },
+  { GPS_LONG_LATI_FIRST_ID, GPS_LONG_LATI_LAST_ID, 0, STR_SENSOR_GPS, UNIT_GPS, 0 },
   { GPS_ALT_FIRST_ID, GPS_ALT_LAST_ID, 0, STR_SENSOR_GPSALT, UNIT_METERS, 2 },
+  { GPS_SPEED_FIRST_ID, GPS_SPEED_LAST_ID, 0, STR_SENSOR_GSPD, UNIT_KTS, 3 },
+  { GPS_COURS_FIRST_ID, GPS_COURS_LAST_ID, 0, STR_SENSOR_HDG, UNIT_DEGREE, 2 },
   { GPS_TIME_DATE_FIRST_ID, GPS_TIME_DATE_LAST_ID, 0, STR_SENSOR_GPSDATETIME, UNIT_DATETIME, 0 },
-  { GPS_LONG_LATI_FIRST_ID, GPS_LONG_LATI_LAST_ID, 0, STR_SENSOR_GPS, UNIT_GPS, 0 },
+  { A3_FIRST_ID, A3_LAST_ID, 0, STR_SENSOR_A3, UNIT_VOLTS, 2 },
+  { A4_FIRST_ID, A4_LAST_ID, 0, STR_SENSOR_A4, UNIT_VOLTS, 2 },
+  { AIR_SPEED_FIRST_ID, AIR_SPEED_LAST_ID, 0, STR_SENSOR_ASPD, UNIT_KTS, 1 },
   { FUEL_QTY_FIRST_ID, FUEL_QTY_LAST_ID, 0, STR_SENSOR_FUEL, UNIT_MILLILITERS, 2 },
-  { GPS_COURS_FIRST_ID, GPS_COURS_LAST_ID, 0, STR_SENSOR_HDG, UNIT_DEGREE, 2 },
   { RBOX_BATT1_FIRST_ID, RBOX_BATT1_LAST_ID, 0, STR_SENSOR_BATT1_VOLTAGE, UNIT_VOLTS, 3 },
-  { RBOX_BATT2_FIRST_ID, RBOX_BATT2_LAST_ID, 0, STR_SENSOR_BATT2_VOLTAGE, UNIT_VOLTS, 3 },
   { RBOX_BATT1_FIRST_ID, RBOX_BATT1_LAST_ID, 1, STR_SENSOR_BATT1_CURRENT, UNIT_AMPS, 2 },
+  { RBOX_BATT2_FIRST_ID, RBOX_BATT2_LAST_ID, 0, STR_SENSOR_BATT2_VOLTAGE, UNIT_VOLTS, 3 },
   { RBOX_BATT2_FIRST_ID, RBOX_BATT2_LAST_ID, 1, STR_SENSOR_BATT2_CURRENT, UNIT_AMPS, 2 },
-  { RBOX_CNSP_FIRST_ID, RBOX_CNSP_LAST_ID, 0, STR_SENSOR_BATT1_CONSUMPTION, UNIT_MAH, 0 },
-  { RBOX_CNSP_FIRST_ID, RBOX_CNSP_LAST_ID, 1, STR_SENSOR_BATT2_CONSUMPTION, UNIT_MAH, 0 },
   { RBOX_STATE_FIRST_ID, RBOX_STATE_LAST_ID, 0, STR_SENSOR_CHANS_STATE, UNIT_BITFIELD, 0 },
   { RBOX_STATE_FIRST_ID, RBOX_STATE_LAST_ID, 1, STR_SENSOR_RB_STATE, UNIT_BITFIELD, 0 },
+  { RBOX_CNSP_FIRST_ID, RBOX_CNSP_LAST_ID, 0, STR_SENSOR_BATT1_CONSUMPTION, UNIT_MAH, 0 },
+  { RBOX_CNSP_FIRST_ID, RBOX_CNSP_LAST_ID, 1, STR_SENSOR_BATT2_CONSUMPTION, UNIT_MAH, 0 },
   { SD1_FIRST_ID, SD1_LAST_ID, 0, STR_SENSOR_SD1_CHANNEL, UNIT_RAW, 0 },
   { ESC_POWER_FIRST_ID, ESC_POWER_LAST_ID, 0, STR_SENSOR_ESC_VOLTAGE, UNIT_VOLTS, 2 },
   { ESC_POWER_FIRST_ID, ESC_POWER_LAST_ID, 1, STR_SENSOR_ESC_CURRENT, UNIT_AMPS, 2 },
   { ESC_RPM_CONS_FIRST_ID, ESC_RPM_CONS_LAST_ID, 0, STR_SENSOR_ESC_RPM, UNIT_RPMS, 0 },
   { ESC_RPM_CONS_FIRST_ID, ESC_RPM_CONS_LAST_ID, 1, STR_SENSOR_ESC_CONSUMPTION, UNIT_MAH, 0 },
   { ESC_TEMPERATURE_FIRST_ID, ESC_TEMPERATURE_LAST_ID, 0, STR_SENSOR_ESC_TEMP, UNIT_CELSIUS, 0 },
+  { RB3040_OUTPUT_FIRST_ID, RB3040_OUTPUT_LAST_ID, 0, STR_RB3040_EXTRA_STATE, UNIT_BITFIELD, 0 },
+  { RB3040_CH1_2_FIRST_ID, RB3040_CH1_2_LAST_ID, 0, STR_RB3040_CHANNEL1, UNIT_AMPS, 2 },
+  { RB3040_CH1_2_FIRST_ID, RB3040_CH1_2_LAST_ID, 1, STR_RB3040_CHANNEL2, UNIT_AMPS, 2 },
+  { RB3040_CH3_4_FIRST_ID, RB3040_CH3_4_LAST_ID, 0, STR_RB3040_CHANNEL3, UNIT_AMPS, 2 },
+  { RB3040_CH3_4_FIRST_ID, RB3040_CH3_4_LAST_ID, 1, STR_RB3040_CHANNEL4, UNIT_AMPS, 2 },
+  { RB3040_CH5_6_FIRST_ID, RB3040_CH5_6_LAST_ID, 0, STR_RB3040_CHANNEL5, UNIT_AMPS, 2 },
+  { RB3040_CH5_6_FIRST_ID, RB3040_CH5_6_LAST_ID, 1, STR_RB3040_CHANNEL6, UNIT_AMPS, 2 },
+  { RB3040_CH7_8_FIRST_ID, RB3040_CH7_8_LAST_ID, 0, STR_RB3040_CHANNEL7, UNIT_AMPS, 2 },
+  { RB3040_CH7_8_FIRST_ID, RB3040_CH7_8_LAST_ID, 1, STR_RB3040_CHANNEL8, UNIT_AMPS, 2 },
   { GASSUIT_TEMP1_FIRST_ID, GASSUIT_TEMP1_LAST_ID, 0, STR_SENSOR_GASSUIT_TEMP1, UNIT_CELSIUS, 0 },
   { GASSUIT_TEMP2_FIRST_ID, GASSUIT_TEMP2_LAST_ID, 0, STR_SENSOR_GASSUIT_TEMP2, UNIT_CELSIUS, 0 },
   { GASSUIT_SPEED_FIRST_ID, GASSUIT_SPEED_LAST_ID, 0, STR_SENSOR_GASSUIT_RPM, UNIT_RPMS, 0 },
@@ -86,25 +86,57 @@ const FrSkySportSensor sportSensors[] = {
   { GASSUIT_AVG_FLOW_FIRST_ID, GASSUIT_AVG_FLOW_LAST_ID, 0, STR_SENSOR_GASSUIT_AVG_FLOW, UNIT_MILLILITERS_PER_MINUTE, 0 },
   { SBEC_POWER_FIRST_ID, SBEC_POWER_LAST_ID, 0, STR_SENSOR_SBEC_VOLTAGE, UNIT_VOLTS, 2 },
   { SBEC_POWER_FIRST_ID, SBEC_POWER_LAST_ID, 1, STR_SENSOR_SBEC_CURRENT, UNIT_AMPS, 2 },
-  { RB3040_OUTPUT_FIRST_ID, RB3040_OUTPUT_LAST_ID, 0, STR_RB3040_EXTRA_STATE, UNIT_BITFIELD, 0 },
-  { RB3040_CH1_2_FIRST_ID, RB3040_CH1_2_LAST_ID, 0, STR_RB3040_CHANNEL1, UNIT_AMPS, 2 },
-  { RB3040_CH1_2_FIRST_ID, RB3040_CH1_2_LAST_ID, 1, STR_RB3040_CHANNEL2, UNIT_AMPS, 2 },
-  { RB3040_CH3_4_FIRST_ID, RB3040_CH3_4_LAST_ID, 0, STR_RB3040_CHANNEL3, UNIT_AMPS, 2 },
-  { RB3040_CH3_4_FIRST_ID, RB3040_CH3_4_LAST_ID, 1, STR_RB3040_CHANNEL4, UNIT_AMPS, 2 },
-  { RB3040_CH5_6_FIRST_ID, RB3040_CH5_6_LAST_ID, 0, STR_RB3040_CHANNEL5, UNIT_AMPS, 2 },
-  { RB3040_CH5_6_FIRST_ID, RB3040_CH5_6_LAST_ID, 1, STR_RB3040_CHANNEL6, UNIT_AMPS, 2 },
-  { RB3040_CH7_8_FIRST_ID, RB3040_CH7_8_LAST_ID, 0, STR_RB3040_CHANNEL7, UNIT_AMPS, 2 },
-  { RB3040_CH7_8_FIRST_ID, RB3040_CH7_8_LAST_ID, 1, STR_RB3040_CHANNEL8, UNIT_AMPS, 2 },
   { SERVO_FIRST_ID, SERVO_LAST_ID, 0, STR_SERVO_CURRENT, UNIT_AMPS, 1 },
   { SERVO_FIRST_ID, SERVO_LAST_ID, 1, STR_SERVO_VOLTAGE, UNIT_VOLTS, 1 },
   { SERVO_FIRST_ID, SERVO_LAST_ID, 2, STR_SERVO_TEMPERATURE, UNIT_CELSIUS, 0 },
   { SERVO_FIRST_ID, SERVO_LAST_ID, 3, STR_SERVO_STATUS, UNIT_TEXT, 0 },
-  { 0, 0, 0, nullptr, UNIT_RAW, 0 } // sentinel
+  { VALID_FRAME_RATE_ID, VALID_FRAME_RATE_ID, 0, STR_VFR, UNIT_PERCENT, 0 },
+  { RSSI_ID, RSSI_ID, 0, STR_SENSOR_RSSI, UNIT_DB, 0 },
+  { ADC1_ID, ADC1_ID, 0, STR_SENSOR_A1, UNIT_VOLTS, 1 },
+  { ADC2_ID, ADC2_ID, 0, STR_SENSOR_A2, UNIT_VOLTS, 1 },
+  { BATT_ID, BATT_ID, 0, STR_SENSOR_BATT, UNIT_VOLTS, 1 },
+  { R9_PWR_ID, R9_PWR_ID, 0, STR_SENSOR_R9PW, UNIT_MILLIWATTS, 0 },
+#if defined(MULTIMODULE)
+  { TX_LQI_ID , TX_LQI_ID,  0, STR_SENSOR_TX_QUALITY, UNIT_RAW, 0 },
+  { TX_RSSI_ID, TX_RSSI_ID, 0, STR_SENSOR_TX_RSSI   , UNIT_DB , 0 },
+#endif
 };
 
+// Each entry follows the previous one: same range with a greater subId,
+// or a range after it without overlap
+static constexpr bool isSportSensorsTableInOrder(unsigned i = 1)
+{
+  return i >= DIM(sportSensors) ||
+         (sportSensors[i].firstId <= sportSensors[i].lastId &&
+          ((sportSensors[i].firstId == sportSensors[i - 1].firstId &&
+            sportSensors[i].lastId == sportSensors[i - 1].lastId &&
+            sportSensors[i].subId > sportSensors[i - 1].subId) ||
+           sportSensors[i].firstId > sportSensors[i - 1].lastId) &&
+          isSportSensorsTableInOrder(i + 1));
+}
+
+static_assert(sportSensors[0].firstId <= sportSensors[0].lastId && isSportSensorsTableInOrder(),
+              "getFrSkySportSensor() needs sportSensors in (firstId, subId) order without overlaps");
+
 const FrSkySportSensor * getFrSkySportSensor(uint16_t id, uint8_t subId=0)
 {
-  for (const FrSkySportSensor * sensor = sportSensors; sensor->firstId; sensor++) {
+  // first sensor which isn't before (id, subId)
+  unsigned first = 0;
+  unsigned count = DIM(sportSensors);
+  while (count > 0) {
+    unsigned step = count / 2;
+    const FrSkySportSensor * sensor = &sportSensors[first + step];
+    if (sensor->lastId < id || (sensor->firstId <= id && sensor->subId < subId)) {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else {
+      count = step;
+    }
+  }
+
+  if (first < DIM(sportSensors)) {
+    const FrSkySportSensor * sensor = &sportSensors[first];
     if (id >= sensor->firstId && id <= sensor->lastId && subId == sensor->subId) {
       return sensor;
     }
@@ -328,9 +360,7 @@ void sportProcessTelemetryPacketWithoutCrc(uint8_t origin, const uint8_t * packe
             luaPacket.primId = primId;
             luaPacket.dataId = dataId;
             luaPacket.value = data;
-            for (uint8_t i=0; i<sizeof(SportTelemetryPacket); i++) {
-              luaInputTelemetryFifo->push(luaPacket.raw[i]);
-            }
+            luaInputTelemetryFifo->push(luaPacket.raw, sizeof(SportTelemetryPacket));
           }
 #endif
         }
@@ -363,9 +393,7 @@ void sportProcessTelemetryPacketWithoutCrc(uint8_t origin, const uint8_t * packe
       luaPacket.primId = primId;
       luaPacket.dataId = dataId;
       luaPacket.value = data;
-      for (uint8_t i=0; i<sizeof(SportTelemetryPacket); i++) {
-        luaInputTelemetryFifo->push(luaPacket.raw[i]);
-      }
+      luaInputTelemetryFifo->push(luaPacket.raw, sizeof(SportTelemetryPacket));
     }
   }
 #endif
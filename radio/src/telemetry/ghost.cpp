@@ -63,7 +63,8 @@ enum
   GHOST_ID_GPS_SATS = 0x0014            // GPS Satellite Count
 };
 
-const GhostSensor ghostSensors[] = {
+// In id order, ghostSensors[id - 1] is the sensor of id
+constexpr GhostSensor ghostSensors[] = {
   {GHOST_ID_RX_RSSI,         STR_RSSI,             UNIT_DB,                0},
   {GHOST_ID_RX_LQ,           STR_RX_QUALITY,       UNIT_PERCENT,           0},
   {GHOST_ID_RX_SNR,          STR_RX_SNR,           UNIT_DB,                0},
@@ -84,14 +85,22 @@ const GhostSensor ghostSensors[] = {
 
   {GHOST_ID_GPS_LAT,         STR_GPS,              UNIT_GPS_LATITUDE,      0},
   {GHOST_ID_GPS_LONG,        STR_GPS,              UNIT_GPS_LONGITUDE,     0},
-  {GHOST_ID_GPS_GSPD,        STR_GSPD,             UNIT_KMH,               1},
-  {GHOST_ID_GPS_HDG,         STR_HDG,              UNIT_DEGREE,            3},
   {GHOST_ID_GPS_ALT,         STR_ALT,              UNIT_METERS,            0},
+  {GHOST_ID_GPS_HDG,         STR_HDG,              UNIT_DEGREE,            3},
+  {GHOST_ID_GPS_GSPD,        STR_GSPD,             UNIT_KMH,               1},
   {GHOST_ID_GPS_SATS,        STR_SATELLITES,       UNIT_RAW,               0},
 
   {0x00,                     NULL,                  UNIT_RAW,               0},
 };
 
+static constexpr bool isGhostSensorsTableInOrder(unsigned i = 0)
+{
+  return ghostSensors[i].id == 0 ||
+         (ghostSensors[i].id == GHOST_ID_RX_RSSI + i && isGhostSensorsTableInOrder(i + 1));
+}
+
+static_assert(isGhostSensorsTableInOrder(), "getGhostSensor() needs ghostSensors in id order");
+
 uint8_t getGhostModuleAddr() {
 #if SPORT_MAX_BAUDRATE < 400000
   return g_model.moduleData[EXTERNAL_MODULE].ghost.telemetryBaudrate == GHST_TELEMETRY_RATE_400K ? GHST_ADDR_MODULE_SYM : GHST_ADDR_MODULE_ASYM;
@@ -102,10 +111,9 @@ uint8_t getGhostModuleAddr() {
 
 const GhostSensor *getGhostSensor(uint8_t id)
 {
-  for (const GhostSensor * sensor = ghostSensors; sensor->id; sensor++) {
-    if (id == sensor->id)
-      return sensor;
-  }
+  // the sentinel isn't a sensor
+  if (id >= GHOST_ID_RX_RSSI && id < DIM(ghostSensors))
+    return &ghostSensors[id - GHOST_ID_RX_RSSI];
   return nullptr;
 }
 
@@ -313,10 +321,8 @@ void processGhostTelemetryFrame()
 #if defined(LUA)
     default:
       if (luaInputTelemetryFifo && luaInputTelemetryFifo->hasSpace(telemetryRxBufferCount-2) ) {
-        for (uint8_t i=1; i<telemetryRxBufferCount-1; i++) {
-          // destination address and CRC are skipped
-          luaInputTelemetryFifo->push(telemetryRxBuffer[i]);
-        }
+        // destination address and CRC are skipped
+        luaInputTelemetryFifo->push(&telemetryRxBuffer[1], telemetryRxBufferCount - 2);
       }
       break;
 #endif
@@ -90,7 +90,8 @@ struct SpektrumSensor {
   const uint8_t precision;
 };
 
-const SpektrumSensor spektrumSensors[] = {
+// Sorted on i2caddress (see getFirstSpektrumSensor())
+constexpr SpektrumSensor spektrumSensors[] = {
   // High voltage internal sensor
   {0x01,             0,  int16,     STR_SENSOR_A1,                UNIT_VOLTS,                  1},
 
@@ -280,6 +281,35 @@ const SpektrumSensor spektrumSensors[] = {
   {0,                0,  int16,     NULL,                   UNIT_RAW,                    0} //sentinel
 };
 
+static constexpr bool isSpektrumSensorsTableInOrder(unsigned i = 1)
+{
+  return i >= DIM(spektrumSensors) - 1 ||
+         (spektrumSensors[i].i2caddress >= spektrumSensors[i - 1].i2caddress &&
+          isSpektrumSensorsTableInOrder(i + 1));
+}
+
+static_assert(isSpektrumSensorsTableInOrder(), "getFirstSpektrumSensor() needs spektrumSensors in i2caddress order");
+
+// Binary search of the first sensor of an I2C address, the sensors of an
+// address follow it. Returns the sentinel, or a sensor of another address,
+// when the address is unknown.
+static const SpektrumSensor * getFirstSpektrumSensor(uint8_t i2cAddress)
+{
+  unsigned first = 0;
+  unsigned count = DIM(spektrumSensors) - 1; // sentinel excluded
+  while (count > 0) {
+    unsigned step = count / 2;
+    if (spektrumSensors[first + step].i2caddress < i2cAddress) {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else {
+      count = step;
+    }
+  }
+  return &spektrumSensors[first];
+}
+
 // The bcd int parameter has wrong endian
 static int32_t bcdToInt16(uint16_t bcd)
 {
@@ -389,85 +419,84 @@ void processSpektrumPacket(const uint8_t *packet)
   }
 
   bool handled = false;
-  for (const SpektrumSensor * sensor = spektrumSensors; sensor->i2caddress; sensor++) {
-    if (i2cAddress == sensor->i2caddress) {
-      handled = true;
+  for (const SpektrumSensor * sensor = getFirstSpektrumSensor(i2cAddress);
+       sensor->i2caddress == i2cAddress; sensor++) {
+    handled = true;
 
-      // Extract value, skip header
-      int32_t value = spektrumGetValue(packet + 4, sensor->startByte, sensor->dataType);
+    // Extract value, skip header
+    int32_t value = spektrumGetValue(packet + 4, sensor->startByte, sensor->dataType);
 
-      if (!isSpektrumValidValue(value, sensor->dataType))
-        continue;
+    if (!isSpektrumValidValue(value, sensor->dataType))
+      continue;
 
-      // mV to VOLT PREC2 for Smart Batteries
-      if ((i2cAddress >= I2C_SMART_BAT_REALTIME  && i2cAddress <= I2C_SMART_BAT_LIMITS) && sensor->unit == UNIT_VOLTS) {
-        if (value == -1) {
-          continue;  // discard unavailable sensors
-        }
-        else {
-          value = value / 10;
-        }
+    // mV to VOLT PREC2 for Smart Batteries
+    if ((i2cAddress >= I2C_SMART_BAT_REALTIME  && i2cAddress <= I2C_SMART_BAT_LIMITS) && sensor->unit == UNIT_VOLTS) {
+      if (value == -1) {
+        continue;  // discard unavailable sensors
       }
-
-      // RPM, 10RPM (0-655340 RPM)
-      if (i2cAddress == I2C_ESC && sensor->unit == UNIT_RPMS) {
+      else {
         value = value / 10;
       }
+    }
 
-      // Current, 10mA (0-655.34A)
-      if (i2cAddress == I2C_ESC && sensor->startByte == 6) {
-        value = value / 10;
-      }
+    // RPM, 10RPM (0-655340 RPM)
+    if (i2cAddress == I2C_ESC && sensor->unit == UNIT_RPMS) {
+      value = value / 10;
+    }
 
-      // BEC Current, 100mA (0-25.4A)
-      if (i2cAddress == I2C_ESC && sensor->startByte == 10) {
-        value = value / 10;
-      }
+    // Current, 10mA (0-655.34A)
+    if (i2cAddress == I2C_ESC && sensor->startByte == 6) {
+      value = value / 10;
+    }
 
-      // Throttle 0.5% (0-127%)
-      if (i2cAddress == I2C_ESC && sensor->startByte == 12) {
-        value = value / 2;
-      }
+    // BEC Current, 100mA (0-25.4A)
+    if (i2cAddress == I2C_ESC && sensor->startByte == 10) {
+      value = value / 10;
+    }
 
-      // Power 0.5% (0-127%)
-      if (i2cAddress == I2C_ESC && sensor->startByte == 13) {
-        value = value / 2;
-      }
+    // Throttle 0.5% (0-127%)
+    if (i2cAddress == I2C_ESC && sensor->startByte == 12) {
+      value = value / 2;
+    }
 
-      if (i2cAddress == I2C_CELLS && sensor->unit == UNIT_VOLTS) {
-        // Map to FrSky style cell values
-        int cellIndex = (sensor->startByte / 2) << 16;
-        value = value | cellIndex;
-      }
+    // Power 0.5% (0-127%)
+    if (i2cAddress == I2C_ESC && sensor->startByte == 13) {
+      value = value / 2;
+    }
 
-      if (sensor->i2caddress == I2C_HIGH_CURRENT && sensor->unit == UNIT_AMPS)
-        // Spektrum's documents talks says: Resolution: 300A/2048 = 0.196791 A/tick
-        // Note that 300/2048 = 0,1464. DeviationTX also uses the 0.196791 figure
-        value = value * 196791 / 100000;
-      else if (sensor->i2caddress == I2C_GPS2 && sensor->unit == UNIT_DATETIME) {
-        // Frsky time is HH:MM:SS:00 bcd encodes while spektrum uses 0HH:MM:SS.S
-        value = (value & 0xfffffff0) << 4;
-      }
+    if (i2cAddress == I2C_CELLS && sensor->unit == UNIT_VOLTS) {
+      // Map to FrSky style cell values
+      int cellIndex = (sensor->startByte / 2) << 16;
+      value = value | cellIndex;
+    }
 
-      // Check if this looks like a LemonRX Transceiver, they use QoS Frame loss A as RSSI indicator(0-100)
-      if (i2cAddress == I2C_QOS && sensor->startByte == 0) {
-        if (spektrumGetValue(packet + 4, 2, uint16) == 0x8000 &&
-            spektrumGetValue(packet + 4, 4, uint16) == 0x8000 &&
-            spektrumGetValue(packet + 4, 6, uint16) == 0x8000 &&
-            spektrumGetValue(packet + 4, 8, uint16) == 0x8000) {
-          telemetryData.rssi.set(value);
-        }
-        else {
-          // Otherwise use the received signal strength of the telemetry packet as indicator
-          // Range is 0-31, multiply by 3 to get an almost full reading for 0x1f, the maximum the cyrf chip reports
-          telemetryData.rssi.set(packet[1] * 3);
-        }
-        telemetryStreaming = TELEMETRY_TIMEOUT10ms;
-      }
+    if (sensor->i2caddress == I2C_HIGH_CURRENT && sensor->unit == UNIT_AMPS)
+      // Spektrum's documents talks says: Resolution: 300A/2048 = 0.196791 A/tick
+      // Note that 300/2048 = 0,1464. DeviationTX also uses the 0.196791 figure
+      value = value * 196791 / 100000;
+    else if (sensor->i2caddress == I2C_GPS2 && sensor->unit == UNIT_DATETIME) {
+      // Frsky time is HH:MM:SS:00 bcd encodes while spektrum uses 0HH:MM:SS.S
+      value = (value & 0xfffffff0) << 4;
+    }
 
-      uint16_t pseudoId = (sensor->i2caddress << 8 | sensor->startByte);
-      setTelemetryValue(PROTOCOL_TELEMETRY_SPEKTRUM, pseudoId, 0, instance, value, sensor->unit, sensor->precision);
+    // Check if this looks like a LemonRX Transceiver, they use QoS Frame loss A as RSSI indicator(0-100)
+    if (i2cAddress == I2C_QOS && sensor->startByte == 0) {
+      if (spektrumGetValue(packet + 4, 2, uint16) == 0x8000 &&
+          spektrumGetValue(packet + 4, 4, uint16) == 0x8000 &&
+          spektrumGetValue(packet + 4, 6, uint16) == 0x8000 &&
+          spektrumGetValue(packet + 4, 8, uint16) == 0x8000) {
+        telemetryData.rssi.set(value);
+      }
+      else {
+        // Otherwise use the received signal strength of the telemetry packet as indicator
+        // Range is 0-31, multiply by 3 to get an almost full reading for 0x1f, the maximum the cyrf chip reports
+        telemetryData.rssi.set(packet[1] * 3);
+      }
+      telemetryStreaming = TELEMETRY_TIMEOUT10ms;
     }
+
+    uint16_t pseudoId = (sensor->i2caddress << 8 | sensor->startByte);
+    setTelemetryValue(PROTOCOL_TELEMETRY_SPEKTRUM, pseudoId, 0, instance, value, sensor->unit, sensor->precision);
   }
   if (!handled) {
     // If we see a sensor that is not handled at all, add the raw values of this sensor to show its existance to
@@ -626,8 +655,8 @@ const SpektrumSensor *getSpektrumSensor(uint16_t pseudoId)
 {
   uint8_t startByte = (uint8_t) (pseudoId & 0xff);
   uint8_t i2cadd = (uint8_t) (pseudoId >> 8);
-  for (const SpektrumSensor * sensor = spektrumSensors; sensor->i2caddress; sensor++) {
-    if (i2cadd == sensor->i2caddress && startByte == sensor->startByte) {
+  for (const SpektrumSensor * sensor = getFirstSpektrumSensor(i2cadd); sensor->i2caddress == i2cadd; sensor++) {
+    if (startByte == sensor->startByte) {
       return sensor;
     }
   }
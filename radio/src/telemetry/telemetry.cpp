@@ -21,6 +21,7 @@
 
 #include "opentx.h"
 #include "multi.h"
+#include "telemetry_capture.h"
 #include "pulses/afhds3.h"
 #include "pulses/flysky.h"
 #include "mixer_scheduler.h"
@@ -230,9 +231,25 @@ static inline bool pollTelemetry(uint8_t module, const etx_module_driver_t* drv,
   uint8_t* rxBuffer = getTelemetryRxBuffer(module);
   uint8_t& rxBufferCount = getTelemetryRxBufferCount(module);
 
+  if (drv->getBytes) {
+    uint8_t data[32];
+    int count = drv->getBytes(ctx, data, sizeof(data));
+    if (count > 0) {
+      LOG_TELEMETRY_WRITE_START(module);
+      do {
+        for (int i = 0; i < count; i++) {
+          telemetryMirrorSend(data[i]);
+          drv->processData(ctx, data[i], rxBuffer, &rxBufferCount);
+          LOG_TELEMETRY_WRITE_BYTE(data[i]);
+        }
+      } while ((count = drv->getBytes(ctx, data, sizeof(data))) > 0);
+    }
+    return true;
+  }
+
   uint8_t data;
   if (drv->getByte(ctx, &data) > 0) {
-    LOG_TELEMETRY_WRITE_START();
+    LOG_TELEMETRY_WRITE_START(module);
     do {
       telemetryMirrorSend(data);
       drv->processData(ctx, data, rxBuffer, &rxBufferCount);
@@ -247,7 +264,7 @@ static inline void pollExtTelemetryLegacy()
 {
   uint8_t data;
   if (telemetryGetByte(&data)) {
-    LOG_TELEMETRY_WRITE_START();
+    LOG_TELEMETRY_WRITE_START(EXTERNAL_MODULE);
     do {
       telemetryMirrorSend(data);
       processTelemetryData(data);
@@ -289,12 +306,7 @@ void telemetryWakeup()
   // TODO: how to switch this OFF ???
   pollExtTelemetryLegacy();
 
-  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
-    const TelemetrySensor & sensor = g_model.telemetrySensors[i];
-    if (sensor.type == TELEM_TYPE_CALCULATED) {
-      telemetryItems[i].eval(sensor);
-    }
-  }
+  evalCalculatedSensors();
 
 #if defined(VARIO)
   if (TELEMETRY_STREAMING() && !IS_FAI_ENABLED()) {
@@ -463,23 +475,32 @@ void telemetryInit(uint8_t protocol)
 
 #if defined(LOG_TELEMETRY) && !defined(SIMU)
 extern VfsFile g_telemetryFile;
-void logTelemetryWriteStart()
+static TelemetryCaptureWriter telemetryCapture;
+
+static bool logTelemetryWrite(const uint8_t * data, uint32_t size)
 {
-  static tmr10ms_t lastTime = 0;
-  tmr10ms_t newTime = get_tmr10ms();
-  if (lastTime != newTime) {
-    struct gtm utm;
-    gettime(&utm);
-    g_telemetryFile.fprintf("\r\n%4d-%02d-%02d,%02d:%02d:%02d.%02d0:",
-             utm.tm_year + TM_YEAR_BASE, utm.tm_mon + 1, utm.tm_mday,
-             utm.tm_hour, utm.tm_min, utm.tm_sec, g_ms100);
-    lastTime = newTime;
-  }
+  size_t written;
+  return g_telemetryFile.write(data, size, written) == VfsError::OK && written == size;
+}
+
+void logTelemetryOpen()
+{
+  telemetryCapture.start(g_telemetryFile.size(), logTelemetryWrite);
+}
+
+void logTelemetryClose()
+{
+  telemetryCapture.close();
+}
+
+void logTelemetryWriteStart(uint8_t module)
+{
+  telemetryCapture.startChunk(get_tmr10ms(), module, g_model.moduleData[module].type, telemetryProtocol);
 }
 
 void logTelemetryWriteByte(uint8_t data)
 {
-  g_telemetryFile.fprintf" %02X", data);
+  telemetryCapture.write(data);
 }
 #endif
 
@@ -76,6 +76,9 @@ void telemetryMirrorSend(uint8_t data);
 void telemetryWakeup();
 void telemetryReset();
 
+// Parses one byte received with the legacy (non module driver) protocols
+void processTelemetryData(uint8_t data);
+
 extern uint8_t telemetryProtocol;
 void telemetryInit(uint8_t protocol);
 
@@ -213,12 +216,14 @@ inline uint8_t modelTelemetryProtocol()
 #include "telemetry_sensors.h"
 
 #if defined(LOG_TELEMETRY) && !defined(SIMU)
-void logTelemetryWriteStart();
+void logTelemetryOpen();
+void logTelemetryClose();
+void logTelemetryWriteStart(uint8_t module);
 void logTelemetryWriteByte(uint8_t data);
-#define LOG_TELEMETRY_WRITE_START()    logTelemetryWriteStart()
-#define LOG_TELEMETRY_WRITE_BYTE(data) logTelemetryWriteByte(data)
+#define LOG_TELEMETRY_WRITE_START(module) logTelemetryWriteStart(module)
+#define LOG_TELEMETRY_WRITE_BYTE(data)    logTelemetryWriteByte(data)
 #else
-#define LOG_TELEMETRY_WRITE_START()
+#define LOG_TELEMETRY_WRITE_START(module)
 #define LOG_TELEMETRY_WRITE_BYTE(data)
 #endif
 #define TELEMETRY_OUTPUT_BUFFER_SIZE  64
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <string.h>
+#include "telemetry_capture.h"
+
+static const uint8_t captureMagic[] = { 'E', 'T', 'X', 'T' };
+
+void TelemetryCaptureWriter::start(uint32_t fileSize, WriteFunction write)
+{
+  writeFunction = write;
+  size = 0;
+  chunk = -1;
+
+  // the first write only completes the last sector of the file
+  limit = TELEMETRY_CAPTURE_SECTOR_SIZE - fileSize % TELEMETRY_CAPTURE_SECTOR_SIZE;
+
+  reserve(TELEMETRY_CAPTURE_HEADER_SIZE);
+  memcpy(&buffer[size], captureMagic, sizeof(captureMagic));
+  size += sizeof(captureMagic);
+  buffer[size++] = TELEMETRY_CAPTURE_VERSION;
+}
+
+bool TelemetryCaptureWriter::close()
+{
+  bool result = true;
+  if (writeFunction && size > 0) {
+    result = writeFunction(buffer, size);
+  }
+  writeFunction = nullptr;
+  size = 0;
+  chunk = -1;
+  return result;
+}
+
+void TelemetryCaptureWriter::startChunk(uint32_t time, uint8_t module, uint8_t moduleType, uint8_t protocol)
+{
+  // bytes received during the same 10ms go in the same chunk
+  if (chunk >= 0 && time == next.time && module == next.module &&
+      moduleType == next.moduleType && protocol == next.protocol) {
+    return;
+  }
+
+  next.time = time;
+  next.module = module;
+  next.moduleType = moduleType;
+  next.protocol = protocol;
+  chunk = -1;
+}
+
+void TelemetryCaptureWriter::write(uint8_t data)
+{
+  if (!writeFunction) {
+    return;
+  }
+
+  if (chunk < 0 || buffer[chunk + TELEMETRY_CAPTURE_CHUNK_SIZE - 1] == 255 || size >= limit) {
+    openChunk();
+  }
+
+  buffer[size++] = data;
+  buffer[chunk + TELEMETRY_CAPTURE_CHUNK_SIZE - 1]++;
+}
+
+bool TelemetryCaptureWriter::flush()
+{
+  // always whole sectors, the end is padded
+  memset(&buffer[size], 0, limit - size);
+  bool result = writeFunction(buffer, limit);
+  size = 0;
+  limit = TELEMETRY_CAPTURE_SECTOR_SIZE;
+  chunk = -1;
+  return result;
+}
+
+void TelemetryCaptureWriter::reserve(uint16_t count)
+{
+  if (size + count > limit) {
+    flush();
+  }
+}
+
+void TelemetryCaptureWriter::openChunk()
+{
+  reserve(TELEMETRY_CAPTURE_CHUNK_SIZE + 1);
+  chunk = size;
+  buffer[size++] = TELEMETRY_CAPTURE_CHUNK;
+  buffer[size++] = next.time;
+  buffer[size++] = next.time >> 8;
+  buffer[size++] = next.time >> 16;
+  buffer[size++] = next.time >> 24;
+  buffer[size++] = next.module;
+  buffer[size++] = next.moduleType;
+  buffer[size++] = next.protocol;
+  buffer[size++] = 0;
+}
+
+bool TelemetryCaptureReader::next(TelemetryCaptureChunk & chunk)
+{
+  while (pos < size) {
+    const uint8_t * header = &data[pos];
+    uint32_t left = size - pos;
+
+    if (header[0] == 0) {
+      // padding
+      pos++;
+    }
+    else if (header[0] == captureMagic[0]) {
+      if (left < TELEMETRY_CAPTURE_HEADER_SIZE || memcmp(header, captureMagic, sizeof(captureMagic)) ||
+          header[sizeof(captureMagic)] != TELEMETRY_CAPTURE_VERSION) {
+        break;
+      }
+      started = true;
+      pos += TELEMETRY_CAPTURE_HEADER_SIZE;
+    }
+    else if (header[0] == TELEMETRY_CAPTURE_CHUNK && started && left >= TELEMETRY_CAPTURE_CHUNK_SIZE) {
+      chunk.time = header[1] + (header[2] << 8) + (header[3] << 16) + ((uint32_t)header[4] << 24);
+      chunk.module = header[5];
+      chunk.moduleType = header[6];
+      chunk.protocol = header[7];
+      chunk.length = header[8];
+      chunk.data = &header[TELEMETRY_CAPTURE_CHUNK_SIZE];
+      if (left - TELEMETRY_CAPTURE_CHUNK_SIZE < chunk.length) {
+        break;
+      }
+      pos += TELEMETRY_CAPTURE_CHUNK_SIZE + chunk.length;
+      return true;
+    }
+    else {
+      break;
+    }
+  }
+
+  corrupted = (pos < size);
+  return false;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _TELEMETRY_CAPTURE_H_
+#define _TELEMETRY_CAPTURE_H_
+
+#include <inttypes.h>
+
+// Raw telemetry captures (LOG_TELEMETRY firmware option). The gtests replay
+// them through the telemetry parsers (tests/telemetry_replay.cpp).
+//
+// File layout (little endian):
+//   'E' 'T' 'X' 'T', version
+//   chunks: 'C', time (u32, 10ms), module, module type, telemetry protocol,
+//           length (u8), received bytes
+//   0 bytes: padding up to the end of a sector
+// A capture appended to an existing file starts again with 'ETXT'.
+
+#define TELEMETRY_CAPTURE_VERSION       1
+#define TELEMETRY_CAPTURE_CHUNK         'C'
+#define TELEMETRY_CAPTURE_HEADER_SIZE   5
+#define TELEMETRY_CAPTURE_CHUNK_SIZE    9
+#define TELEMETRY_CAPTURE_SECTOR_SIZE   512
+
+struct TelemetryCaptureChunk
+{
+  uint32_t time;
+  uint8_t module;
+  uint8_t moduleType;
+  uint8_t protocol;
+  uint8_t length;
+  const uint8_t * data;
+};
+
+// Packs the received bytes into chunks in a one sector buffer, which is only
+// written when full (or when the capture is closed)
+class TelemetryCaptureWriter
+{
+  public:
+    typedef bool (*WriteFunction)(const uint8_t * data, uint32_t size);
+
+    // fileSize is the size of the file the capture is appended to
+    void start(uint32_t fileSize, WriteFunction write);
+    bool close();
+
+    // the following bytes were received at time from module
+    void startChunk(uint32_t time, uint8_t module, uint8_t moduleType, uint8_t protocol);
+    void write(uint8_t data);
+
+  protected:
+    uint8_t buffer[TELEMETRY_CAPTURE_SECTOR_SIZE];
+    WriteFunction writeFunction = nullptr;
+    uint16_t size = 0;    // bytes used in buffer
+    uint16_t limit = 0;   // bytes up to the end of the sector
+    int16_t chunk = -1;   // offset of the chunk being written, -1 if none
+    TelemetryCaptureChunk next = {};
+
+    bool flush();
+    void reserve(uint16_t count);
+    void openChunk();
+};
+
+class TelemetryCaptureReader
+{
+  public:
+    TelemetryCaptureReader(const uint8_t * data, uint32_t size):
+      data(data),
+      size(size)
+    {
+    }
+
+    // returns false at the end of the capture, or when it is corrupted
+    bool next(TelemetryCaptureChunk & chunk);
+
+    bool isCorrupted() const
+    {
+      return corrupted;
+    }
+
+  protected:
+    const uint8_t * data;
+    uint32_t size;
+    uint32_t pos = 0;
+    bool started = false;
+    bool corrupted = false;
+};
+
+#endif // _TELEMETRY_CAPTURE_H_
@@ -145,6 +145,8 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32
       cells.count = cellsCount;
     }
     cells.values[cellIndex].set(cellValue);
+    // the cells sensors get the new cell value right away
+    changeCount++;
     if (cellIndex+1 == cells.count) {
       newVal = 0;
       for (int i=0; i<cellsCount; i++) {
@@ -494,6 +496,118 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
   }
 }
 
+// Calculated sensors evaluated by TelemetryItem::eval(), with their sources,
+// compiled when the model changes (see modelDataRevision). A sensor is only
+// evaluated again when the changeCount of one of its sources moved, i.e.
+// when a source got a new value or became old. Consumption and totalize
+// sensors are not listed, they are updated by per10ms() and setValue().
+#define CALCULATED_SENSOR_MAX_SOURCES  4
+
+static struct {
+  bool valid;
+  uint32_t revision;
+  uint8_t count;
+  struct {
+    uint8_t index;
+    uint8_t sourcesCount;
+    uint8_t sources[CALCULATED_SENSOR_MAX_SOURCES];
+    uint8_t changeCounts[CALCULATED_SENSOR_MAX_SOURCES]; // as seen at the last eval()
+  } sensors[MAX_TELEMETRY_SENSORS];
+} calculatedSensors;
+
+static uint8_t getCalculatedSensorSources(const TelemetrySensor & sensor, uint8_t * sources)
+{
+  uint8_t count = 0;
+
+  auto addSource = [&](int source) {
+    if (source > 0 && source <= MAX_TELEMETRY_SENSORS) {
+      sources[count++] = source - 1;
+    }
+  };
+
+  switch (sensor.formula) {
+    case TELEM_FORMULA_CELL:
+      addSource(sensor.cell.source);
+      break;
+
+    case TELEM_FORMULA_DIST:
+      addSource(sensor.dist.gps);
+      addSource(sensor.dist.alt);
+      break;
+
+    case TELEM_FORMULA_MULTIPLY:
+      addSource(abs(sensor.calc.sources[0]));
+      addSource(abs(sensor.calc.sources[1]));
+      break;
+
+    default:
+      for (int i = 0; i < CALCULATED_SENSOR_MAX_SOURCES; i++) {
+        addSource(abs(sensor.calc.sources[i]));
+      }
+      break;
+  }
+
+  return count;
+}
+
+static void buildCalculatedSensors()
+{
+  uint8_t count = 0;
+
+  for (uint8_t index = 0; index < MAX_TELEMETRY_SENSORS; index++) {
+    const TelemetrySensor & sensor = g_model.telemetrySensors[index];
+    if (sensor.type != TELEM_TYPE_CALCULATED ||
+        sensor.formula == TELEM_FORMULA_CONSUMPTION ||
+        sensor.formula == TELEM_FORMULA_TOTALIZE) {
+      continue;
+    }
+
+    uint8_t sources[CALCULATED_SENSOR_MAX_SOURCES];
+    uint8_t sourcesCount = getCalculatedSensorSources(sensor, sources);
+
+    // an entry which did not change keeps the changeCounts it has seen
+    auto & calculated = calculatedSensors.sensors[count++];
+    if (calculated.index != index || calculated.sourcesCount != sourcesCount ||
+        memcmp(calculated.sources, sources, sourcesCount) != 0) {
+      calculated.index = index;
+      calculated.sourcesCount = sourcesCount;
+      memcpy(calculated.sources, sources, sourcesCount);
+      for (uint8_t i = 0; i < sourcesCount; i++) {
+        calculated.changeCounts[i] = telemetryItems[sources[i]].changeCount - 1;
+      }
+    }
+  }
+
+  calculatedSensors.count = count;
+  calculatedSensors.revision = modelDataRevision;
+  calculatedSensors.valid = true;
+}
+
+void evalCalculatedSensors()
+{
+  if (!calculatedSensors.valid || calculatedSensors.revision != modelDataRevision) {
+    buildCalculatedSensors();
+  }
+
+  for (uint8_t i = 0; i < calculatedSensors.count; i++) {
+    auto & calculated = calculatedSensors.sensors[i];
+
+    // a sensor without sources (sum of nothing) is evaluated every time
+    bool changed = (calculated.sourcesCount == 0);
+    for (uint8_t j = 0; j < calculated.sourcesCount; j++) {
+      uint8_t changeCount = telemetryItems[calculated.sources[j]].changeCount;
+      if (changeCount != calculated.changeCounts[j]) {
+        calculated.changeCounts[j] = changeCount;
+        changed = true;
+      }
+    }
+
+    if (changed) {
+      telemetryItems[calculated.index].eval(g_model.telemetrySensors[calculated.index]);
+    }
+  }
+}
+
 void delTelemetryIndex(uint8_t index)
 {
   memclear(&g_model.telemetrySensors[index], sizeof(TelemetrySensor));
@@ -523,19 +637,72 @@ int lastUsedTelemetryIndex()
   return -1;
 }
 
+// Custom sensors hashed on id / subId, so that decoding a value doesn't scan
+// the whole sensors table. The instance is not part of the key as it may
+// change on the fly (see isSameInstance()). The index is rebuilt when the
+// model changes, and a lookup miss is always confirmed by a full scan
+// before a new sensor gets created.
+#define TELEMETRY_SENSORS_HASH_BITS  7
+#define TELEMETRY_SENSORS_HASH_SIZE  (1 << TELEMETRY_SENSORS_HASH_BITS)
+#define TELEMETRY_SENSORS_NONE       0xFF
+
+static struct {
+  bool valid;
+  uint32_t revision;
+  uint8_t first[TELEMETRY_SENSORS_HASH_SIZE];
+  uint8_t next[MAX_TELEMETRY_SENSORS];
+} sensorsIndex;
+
+static inline uint8_t getSensorHash(uint16_t id, uint8_t subId)
+{
+  return ((id | ((uint32_t)subId << 16)) * 0x9E3779B1u) >>
+         (32 - TELEMETRY_SENSORS_HASH_BITS);
+}
+
+static void buildSensorsIndex()
+{
+  memset(sensorsIndex.first, TELEMETRY_SENSORS_NONE, sizeof(sensorsIndex.first));
+
+  // walk backwards so that each bucket lists the sensors in index order
+  for (int index = MAX_TELEMETRY_SENSORS - 1; index >= 0; index--) {
+    TelemetrySensor &telemetrySensor = g_model.telemetrySensors[index];
+    if (telemetrySensor.type == TELEM_TYPE_CUSTOM) {
+      uint8_t hash = getSensorHash(telemetrySensor.id, telemetrySensor.subId);
+      sensorsIndex.next[index] = sensorsIndex.first[hash];
+      sensorsIndex.first[hash] = index;
+    }
+    else {
+      sensorsIndex.next[index] = TELEMETRY_SENSORS_NONE;
+    }
+  }
+
+  sensorsIndex.revision = modelDataRevision;
+  sensorsIndex.valid = true;
+}
+
+static inline bool isSensorMatching(TelemetrySensor &telemetrySensor,
+                                    TelemetryProtocol protocol, uint16_t id,
+                                    uint8_t subId, uint8_t instance)
+{
+  return telemetrySensor.type == TELEM_TYPE_CUSTOM && telemetrySensor.id == id &&
+         telemetrySensor.subId == subId &&
+         (telemetrySensor.isSameInstance(protocol, instance) ||
+          g_model.ignoreSensorIds);
+}
+
 template <class T>
 int setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t subId, uint8_t instance, T value, uint32_t unit = 0, uint32_t prec = 0)
 {
   bool sensorFound = false;
 
-  for (int index = 0; index < MAX_TELEMETRY_SENSORS; index++) {
-    TelemetrySensor &telemetrySensor = g_model.telemetrySensors[index];
-
-    if (telemetrySensor.type == TELEM_TYPE_CUSTOM && telemetrySensor.id == id &&
-        telemetrySensor.subId == subId &&
-        (telemetrySensor.isSameInstance(protocol, instance) ||
-         g_model.ignoreSensorIds)) {
+  if (!sensorsIndex.valid || sensorsIndex.revision != modelDataRevision) {
+    buildSensorsIndex();
+  }
 
+  for (uint8_t index = sensorsIndex.first[getSensorHash(id, subId)];
+       index != TELEMETRY_SENSORS_NONE; index = sensorsIndex.next[index]) {
+    TelemetrySensor &telemetrySensor = g_model.telemetrySensors[index];
+    if (isSensorMatching(telemetrySensor, protocol, id, subId, instance)) {
       telemetryItems[index].setValue(telemetrySensor, value, unit, prec);
       sensorFound = true;
       // we continue search here, because sensors can share the same id and
@@ -547,8 +714,23 @@ int setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t subId, ui
     return -1;
   }
 
+  // the index may be outdated (sensor being created by another task)
+  for (int index = 0; index < MAX_TELEMETRY_SENSORS; index++) {
+    TelemetrySensor &telemetrySensor = g_model.telemetrySensors[index];
+    if (isSensorMatching(telemetrySensor, protocol, id, subId, instance)) {
+      telemetryItems[index].setValue(telemetrySensor, value, unit, prec);
+      sensorFound = true;
+    }
+  }
+
+  if (sensorFound) {
+    sensorsIndex.valid = false;
+    return -1;
+  }
+
   int index = availableTelemetryIndex();
   if (index >= 0) {
+    sensorsIndex.valid = false;
     switch (protocol) {
       case PROTOCOL_TELEMETRY_FRSKY_SPORT:
         frskySportSetDefault(index, id, subId, instance);
@@ -49,6 +49,10 @@ class TelemetryItem
 
     int8_t timeout; // for detection of sensor loss
 
+    // incremented each time the item gets a value or becomes old, the
+    // calculated sensors are only evaluated when one of their sources changed
+    uint8_t changeCount;
+
     union {
       struct {
         int32_t  offsetAuto;
@@ -81,13 +85,16 @@ class TelemetryItem
 
     TelemetryItem()
     {
+      changeCount = 0;
       clear();
     }
 
     void clear()
     {
+      uint8_t count = changeCount;
       memset(reinterpret_cast<void*>(this), 0, sizeof(TelemetryItem));
       timeout = TELEMETRY_SENSOR_TIMEOUT_UNAVAILABLE;
+      changeCount = count + 1;
     }
 
     void eval(const TelemetrySensor & sensor);
@@ -125,15 +132,20 @@ class TelemetryItem
     inline void setFresh()
     {
       timeout = TELEMETRY_SENSOR_TIMEOUT_START;
+      changeCount++;
     }
 
     inline void setOld()
     {
-      timeout = TELEMETRY_SENSOR_TIMEOUT_OLD;
+      if (timeout != TELEMETRY_SENSOR_TIMEOUT_OLD) {
+        timeout = TELEMETRY_SENSOR_TIMEOUT_OLD;
+        changeCount++;
+      }
     }
 };
 
 extern TelemetryItem telemetryItems[MAX_TELEMETRY_SENSORS];
+void evalCalculatedSensors();
 extern uint8_t allowNewSensors;
 bool isFaiForbidden(source_t idx);
 
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+
+#include "gtests.h"
+#include "crc.h"
+
+// Byte by byte references, the way the CRCs were computed before slicing
+static uint8_t crc8Reference(uint8_t poly, const uint8_t * ptr, uint32_t len, uint8_t crc = 0)
+{
+  while (len--) {
+    crc ^= *ptr++;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ poly : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+static uint16_t crc16Reference(const unsigned short * tab, const uint8_t * buf, uint32_t len, uint16_t crc = 0)
+{
+  while (len--) {
+    crc = (crc << 8) ^ tab[((crc >> 8) ^ *buf++) & 0xFF];
+  }
+  return crc;
+}
+
+class CrcTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+      uint32_t seed = 12345;
+      for (unsigned i = 0; i < sizeof(data); i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+      }
+    }
+
+    uint8_t data[1024 + 7];
+};
+
+TEST_F(CrcTest, crc8)
+{
+  for (uint32_t offset = 0; offset < 4; offset++) {
+    for (uint32_t len = 0; len < 300; len++) {
+      EXPECT_EQ(crc8Reference(0xD5, data + offset, len), crc8(data + offset, len));
+      EXPECT_EQ(crc8Reference(0xBA, data + offset, len), crc8_BA(data + offset, len));
+    }
+  }
+}
+
+TEST_F(CrcTest, crc16)
+{
+  for (uint32_t offset = 0; offset < 4; offset++) {
+    for (uint32_t len = 0; len < 300; len++) {
+      EXPECT_EQ(crc16Reference(crc16tab_1021, data + offset, len), crc16(CRC_1021, data + offset, len));
+      EXPECT_EQ(crc16Reference(crc16tab_1189, data + offset, len), crc16(CRC_1189, data + offset, len));
+      EXPECT_EQ(crc16Reference(crc16tab_1021, data + offset, len, 0xFFFF), crc16(CRC_1021, data + offset, len, 0xFFFF));
+    }
+  }
+}
+
+TEST_F(CrcTest, streaming)
+{
+  const uint32_t len = 100;
+  for (uint32_t split = 0; split <= len; split++) {
+    EXPECT_EQ(crc8(data, len), crc8(data + split, len - split, crc8(data, split)));
+    EXPECT_EQ(crc8_BA(data, len), crc8_BA(data + split, len - split, crc8_BA(data, split)));
+    EXPECT_EQ(crc16(CRC_1021, data, len), crc16(CRC_1021, data + split, len - split, crc16(CRC_1021, data, split)));
+    EXPECT_EQ(crc16(CRC_1189, data, len), crc16(CRC_1189, data + split, len - split, crc16(CRC_1189, data, split)));
+  }
+
+  uint8_t crc = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    crc = crc8_update(crc, data[i]);
+  }
+  EXPECT_EQ(crc8(data, len), crc);
+}
+
+// Not a pass / fail test, it only reports the speed-up on the host:
+// run with --gtest_also_run_disabled_tests
+TEST_F(CrcTest, DISABLED_benchmark)
+{
+  typedef std::chrono::steady_clock clock;
+  const int loops = 2000;
+  volatile uint32_t sink = 0;
+
+  auto measure = [&](const char * name, uint32_t (*reference)(const uint8_t *, uint32_t),
+                     uint32_t (*sliced)(const uint8_t *, uint32_t)) {
+    auto start = clock::now();
+    for (int i = 0; i < loops; i++) sink += reference(data, 1024);
+    auto middle = clock::now();
+    for (int i = 0; i < loops; i++) sink += sliced(data, 1024);
+    auto end = clock::now();
+    // picoseconds per byte
+    double before = std::chrono::duration<double, std::pico>(middle - start).count() / (loops * 1024.0);
+    double after = std::chrono::duration<double, std::pico>(end - middle).count() / (loops * 1024.0);
+    RecordProperty(std::string(name) + "ByteWisePs", (int)before);
+    RecordProperty(std::string(name) + "SlicedPs", (int)after);
+  };
+
+  measure("crc8",
+          [](const uint8_t * p, uint32_t l) -> uint32_t { uint8_t crc = 0; while (l--) crc = crc8_update(crc, *p++); return crc; },
+          [](const uint8_t * p, uint32_t l) -> uint32_t { return crc8(p, l); });
+  measure("crc16_1021",
+          [](const uint8_t * p, uint32_t l) -> uint32_t { return crc16Reference(crc16tab_1021, p, l); },
+          [](const uint8_t * p, uint32_t l) -> uint32_t { return crc16(CRC_1021, p, l); });
+  measure("crc16_1189",
+          [](const uint8_t * p, uint32_t l) -> uint32_t { return crc16Reference(crc16tab_1189, p, l); },
+          [](const uint8_t * p, uint32_t l) -> uint32_t { return crc16(CRC_1189, p, l); });
+}
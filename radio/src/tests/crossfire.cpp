@@ -20,9 +20,24 @@
  */
 
 #include "gtests.h"
+#include "telemetry/crossfire.h"
 
 #if defined(CROSSFIRE)
-uint8_t createCrossfireChannelsFrame(uint8_t * frame, int16_t * pulses);
+uint8_t createCrossfireChannelsFrame(uint8_t * frame, int16_t * pulses, uint8_t nChannels);
+uint8_t createCrossfireSubsetChannelsFrame(uint8_t * frame, int16_t * pulses, uint8_t first, uint8_t count);
+
+// Reads the 11 bits channel ch from a packed payload
+static uint16_t unpackCrossfireChannel(const uint8_t * payload, uint8_t ch)
+{
+  uint16_t value = 0;
+  for (int bit = 0; bit < 11; bit++) {
+    int pos = ch * 11 + bit;
+    if (payload[pos / 8] & (1 << (pos % 8)))
+      value |= 1 << bit;
+  }
+  return value;
+}
+
 TEST(Crossfire, createCrossfireChannelsFrame)
 {
   int16_t pulsesStart[MAX_TRAINER_CHANNELS];
@@ -33,9 +48,41 @@ TEST(Crossfire, createCrossfireChannelsFrame)
     pulsesStart[i] = -1024 + (2048 / MAX_TRAINER_CHANNELS) * i;
   }
 
-  createCrossfireChannelsFrame(crossfire, pulsesStart);
+  EXPECT_EQ(26, createCrossfireChannelsFrame(crossfire, pulsesStart, CROSSFIRE_CHANNELS_COUNT));
+  EXPECT_EQ(MODULE_ADDRESS, crossfire[0]);
+  EXPECT_EQ(24, crossfire[1]);
+  EXPECT_EQ(CHANNELS_ID, crossfire[2]);
+  EXPECT_EQ(crc8(&crossfire[2], 23), crossfire[25]);
+  for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
+    EXPECT_EQ(0x3E0 + (pulsesStart[i] * 4) / 5, unpackCrossfireChannel(&crossfire[3], i));
+  }
+
+  // channels above nChannels are centered
+  createCrossfireChannelsFrame(crossfire, pulsesStart, 5);
+  for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
+    EXPECT_EQ(i < 5 ? 0x3E0 + (pulsesStart[i] * 4) / 5 : 0x3E0, unpackCrossfireChannel(&crossfire[3], i));
+  }
+}
+
+TEST(Crossfire, createCrossfireSubsetChannelsFrame)
+{
+  int16_t pulses[CROSSFIRE_CHANNELS_COUNT] = {0};
+  uint8_t crossfire[CROSSFIRE_FRAME_MAXLEN];
+
+  pulses[3] = -1024;
+  pulses[4] = 512;
+  pulses[5] = 1024;
 
-  // TODO check
+  // 3 channels: 1(ID) + 1(first/resolution) + 5 + 1(CRC)
+  EXPECT_EQ(10, createCrossfireSubsetChannelsFrame(crossfire, pulses, 3, 3));
+  EXPECT_EQ(MODULE_ADDRESS, crossfire[0]);
+  EXPECT_EQ(8, crossfire[1]);
+  EXPECT_EQ(SUBSET_CHANNELS_ID, crossfire[2]);
+  EXPECT_EQ(3 | (1 << 5), crossfire[3]);
+  EXPECT_EQ(0x000, unpackCrossfireChannel(&crossfire[4], 0));
+  EXPECT_EQ(0x600, unpackCrossfireChannel(&crossfire[4], 1));
+  EXPECT_EQ(0x7FF, unpackCrossfireChannel(&crossfire[4], 2));
+  EXPECT_EQ(crc8(&crossfire[2], 7), crossfire[9]);
 }
 
 TEST(Crossfire, crc8)
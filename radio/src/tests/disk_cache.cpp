@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#if defined(DISK_CACHE)
+
+#define RAMDISK_SECTORS   2048
+
+// RAM disk behind the cache, and what it should contain once flushed
+static uint8_t ramDisk[RAMDISK_SECTORS * BLOCK_SIZE];
+static uint8_t expected[RAMDISK_SECTORS * BLOCK_SIZE];
+
+DRESULT __disk_read(BYTE drv, BYTE * buff, DWORD sector, UINT count)
+{
+  if (sector + count > RAMDISK_SECTORS) return RES_PARERR;
+  memcpy(buff, &ramDisk[sector * BLOCK_SIZE], count * BLOCK_SIZE);
+  return RES_OK;
+}
+
+DRESULT __disk_write(BYTE drv, const BYTE * buff, DWORD sector, UINT count)
+{
+  if (sector + count > RAMDISK_SECTORS) return RES_PARERR;
+  memcpy(&ramDisk[sector * BLOCK_SIZE], buff, count * BLOCK_SIZE);
+  return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void * buff)
+{
+  switch (ctrl) {
+    case GET_SECTOR_COUNT:
+      *(DWORD *)buff = RAMDISK_SECTORS;
+      return RES_OK;
+    case CTRL_SYNC:
+      return diskCache[drv].flush(drv);
+    default:
+      return RES_PARERR;
+  }
+}
+
+class DiskCacheTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+      for (unsigned i = 0; i < sizeof(ramDisk); i++) {
+        ramDisk[i] = i * 7 + (i >> 9);
+      }
+      memcpy(expected, ramDisk, sizeof(ramDisk));
+      diskCache[0].clear();
+      seed = 12345;
+    }
+
+    void TearDown() override
+    {
+      diskCache[0].setWriteBack(0, false);
+    }
+
+    uint32_t random(uint32_t max)
+    {
+      seed = seed * 1103515245 + 12345;
+      return (seed >> 16) % max;
+    }
+
+    void write(DWORD sector, UINT count)
+    {
+      uint8_t buff[64 * BLOCK_SIZE];
+      for (UINT i = 0; i < count * BLOCK_SIZE; i++) {
+        buff[i] = random(256);
+      }
+      memcpy(&expected[sector * BLOCK_SIZE], buff, count * BLOCK_SIZE);
+      ASSERT_EQ(RES_OK, disk_write(0, buff, sector, count));
+    }
+
+    void read(DWORD sector, UINT count)
+    {
+      uint8_t buff[64 * BLOCK_SIZE];
+      ASSERT_EQ(RES_OK, disk_read(0, buff, sector, count));
+      ASSERT_EQ(0, memcmp(buff, &expected[sector * BLOCK_SIZE], count * BLOCK_SIZE))
+          << "sector " << sector << " count " << count;
+    }
+
+    // random accesses, mostly small and close to each other like FatFs does
+    void randomAccesses(int count, bool sync)
+    {
+      DWORD sector = 0;
+      for (int i = 0; i < count; i++) {
+        if (random(4) == 0 || sector + 64 > RAMDISK_SECTORS) {
+          sector = random(RAMDISK_SECTORS - 64);
+        }
+        UINT len = (random(8) == 0 ? 1 + random(64) : 1 + random(4));
+        switch (random(3)) {
+          case 0:
+            write(sector, len);
+            sector += len;
+            break;
+          case 1:
+            read(sector, len);
+            sector += len;
+            break;
+          default:
+            read(random(RAMDISK_SECTORS - 64), len);
+            break;
+        }
+        if (sync && random(16) == 0) {
+          // once synced, what is on the disk is what FatFs wrote
+          ASSERT_EQ(RES_OK, disk_ioctl(0, CTRL_SYNC, nullptr));
+          ASSERT_EQ(0, memcmp(ramDisk, expected, sizeof(ramDisk)));
+        }
+      }
+    }
+
+    uint32_t seed;
+};
+
+TEST_F(DiskCacheTest, WriteThrough)
+{
+  randomAccesses(5000, false);
+  EXPECT_EQ(0, memcmp(ramDisk, expected, sizeof(ramDisk)));
+  EXPECT_EQ(diskCache[0].getStats().noWrites, diskCache[0].getStats().noDiskWrites);
+}
+
+TEST_F(DiskCacheTest, WriteBackConsistency)
+{
+  diskCache[0].setWriteBack(0, true);
+  randomAccesses(5000, true);
+  ASSERT_EQ(RES_OK, disk_ioctl(0, CTRL_SYNC, nullptr));
+  EXPECT_EQ(0, memcmp(ramDisk, expected, sizeof(ramDisk)));
+}
+
+TEST_F(DiskCacheTest, WriteBackCoalescing)
+{
+  diskCache[0].setWriteBack(0, true);
+
+  // sectors appended one by one, one of them rewritten
+  for (int i = 0; i < 2 * DISK_CACHE_WRITE_SECTORS; i++) {
+    write(100 + i, 1);
+    if (i == 10) write(105, 1);
+  }
+  read(120, 20);
+  read(150, 4);
+  ASSERT_EQ(RES_OK, disk_ioctl(0, CTRL_SYNC, nullptr));
+  EXPECT_EQ(0, memcmp(ramDisk, expected, sizeof(ramDisk)));
+  EXPECT_EQ(2u, diskCache[0].getStats().noDiskWrites);
+
+  // a cached block is updated in place
+  read(512, 1);
+  uint32_t misses = diskCache[0].getStats().noMisses;
+  write(513, 2);
+  read(512, 4);
+  EXPECT_EQ(misses, diskCache[0].getStats().noMisses);
+
+  // nothing stays pending for more than the timeout
+  g_tmr10ms += DISK_CACHE_WRITE_TIMEOUT;
+  read(0, 1);
+  EXPECT_EQ(0, memcmp(ramDisk, expected, sizeof(ramDisk)));
+  EXPECT_EQ(3u, diskCache[0].getStats().noDiskWrites);
+
+  // even without any further access
+  write(700, 1);
+  diskCache[0].checkTimeout(0);
+  EXPECT_EQ(3u, diskCache[0].getStats().noDiskWrites);
+  g_tmr10ms += DISK_CACHE_WRITE_TIMEOUT;
+  diskCache[0].checkTimeout(0);
+  EXPECT_EQ(0, memcmp(ramDisk, expected, sizeof(ramDisk)));
+  EXPECT_EQ(4u, diskCache[0].getStats().noDiskWrites);
+}
+
+#endif
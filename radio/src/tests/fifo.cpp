@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+#include "fifo.h"
+
+TEST(Fifo, bulkPushPop)
+{
+  Fifo<uint8_t, 16> fifo;
+  uint8_t in[32], out[32];
+  for (int i = 0; i < 32; i++) in[i] = i;
+
+  // only N - 1 elements fit
+  EXPECT_EQ(15u, fifo.push(in, 20));
+  EXPECT_TRUE(fifo.isFull());
+  EXPECT_EQ(10u, fifo.pop(out, 10));
+  EXPECT_EQ(0, memcmp(in, out, 10));
+
+  // wraps around the end of the buffer
+  EXPECT_EQ(8u, fifo.push(in + 15, 8));
+  EXPECT_EQ(13u, fifo.size());
+  EXPECT_EQ(13u, fifo.pop(out, 32));
+  EXPECT_EQ(0, memcmp(in + 10, out, 13));
+  EXPECT_TRUE(fifo.isEmpty());
+  EXPECT_EQ(0u, fifo.pop(out, 1));
+}
+
+TEST(Fifo, spans)
+{
+  Fifo<uint8_t, 16> fifo;
+  uint8_t * span;
+
+  EXPECT_EQ(15u, fifo.writeSpan(span));
+  memset(span, 0xAA, 12);
+  fifo.commit(12);
+  EXPECT_EQ(12u, fifo.readSpan(span));
+  fifo.skip(12);
+
+  // free space is split by the end of the buffer
+  EXPECT_EQ(4u, fifo.writeSpan(span));
+  for (int i = 0; i < 4; i++) span[i] = i;
+  fifo.commit(4);
+  EXPECT_EQ(11u, fifo.writeSpan(span));
+  for (int i = 0; i < 3; i++) span[i] = 4 + i;
+  fifo.commit(3);
+
+  uint8_t value;
+  EXPECT_TRUE(fifo.peek(5, value));
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(fifo.peek(7, value));
+
+  EXPECT_EQ(4u, fifo.readSpan(span));
+  fifo.skip(4);
+  EXPECT_EQ(3u, fifo.readSpan(span));
+  EXPECT_EQ(4, span[0]);
+}
@@ -358,6 +358,7 @@ TEST(FrSkySPORT, frskySetCellVoltageTwoSensors)
   g_model.telemetrySensors[2].prec = 1;
   g_model.telemetrySensors[2].calc.sources[0] = 1;
   g_model.telemetrySensors[2].calc.sources[1] = 2;
+  MODEL_CHANGED();
 
   telemetryWakeup();
 
@@ -378,6 +379,46 @@ TEST(FrSkySPORT, frskySetCellVoltageTwoSensors)
   EXPECT_EQ(telemetryItems[2].valueMax, 287);
 }
 
+TEST(FrSkySPORT, calculatedSensorsOnlyEvaluatedOnChange)
+{
+  uint8_t packet[FRSKY_SPORT_PACKET_SIZE];
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  telemetryStreaming = TELEMETRY_TIMEOUT10ms;
+  telemetryData.telemetryValid = 0x07;
+  allowNewSensors = true;
+
+  generateSportCellPacket(packet, 3, 0, 418, 416); sportProcessTelemetryPacket(packet);
+  generateSportCellPacket(packet, 3, 2, 415,   0); sportProcessTelemetryPacket(packet);
+  generateSportCellPacket(packet, 4, 0, 410, 420, DATA_ID_FLVSS+1); sportProcessTelemetryPacket(packet);
+  generateSportCellPacket(packet, 4, 2, 400, 405, DATA_ID_FLVSS+1); sportProcessTelemetryPacket(packet);
+
+  g_model.telemetrySensors[2].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[2].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[2].prec = 1;
+  g_model.telemetrySensors[2].calc.sources[0] = 1;
+  g_model.telemetrySensors[2].calc.sources[1] = 2;
+  MODEL_CHANGED();
+
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[2].value, 287);
+
+  // no new source value, no evaluation
+  telemetryItems[2].value = 0;
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[2].value, 0);
+
+  generateSportCellPacket(packet, 3, 2, 415,   0); sportProcessTelemetryPacket(packet);
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[2].value, 287);
+
+  // a source which times out is a change as well
+  telemetryItems[0].setOld();
+  telemetryWakeup();
+  EXPECT_TRUE(telemetryItems[2].isOld());
+}
+
 void generateSportFasVoltagePacket(uint8_t * packet, uint32_t voltage)
 {
   packet[0] = 0x22; //DATA_ID_FAS
@@ -490,3 +531,77 @@ TEST(FrSkySPORT, frskyCurrent)
   EXPECT_EQ(telemetryItems[0].valueMax, 505);
 }
 
+
+TEST(FrSkySPORT, sensorsSharingSameId)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  telemetryStreaming = TELEMETRY_TIMEOUT10ms;
+  telemetryData.telemetryValid = 0x07;
+  allowNewSensors = true;
+
+  for (int i = 0; i < 20; i++) {
+    setTelemetryValue(PROTOCOL_TELEMETRY_FRSKY_SPORT, 0x5100 + i, 0, 0x01, i, UNIT_RAW, 0);
+  }
+  EXPECT_EQ(telemetryItems[5].value, 5);
+  EXPECT_EQ(telemetryItems[19].value, 19);
+
+  // a copy of sensor 7 gets the same values
+  g_model.telemetrySensors[20] = g_model.telemetrySensors[7];
+  MODEL_CHANGED();
+  setTelemetryValue(PROTOCOL_TELEMETRY_FRSKY_SPORT, 0x5107, 0, 0x01, 77, UNIT_RAW, 0);
+  EXPECT_EQ(telemetryItems[7].value, 77);
+  EXPECT_EQ(telemetryItems[20].value, 77);
+  EXPECT_EQ(telemetryItems[6].value, 6);
+
+  // another subId is another sensor
+  setTelemetryValue(PROTOCOL_TELEMETRY_FRSKY_SPORT, 0x5107, 1, 0x01, 55, UNIT_RAW, 0);
+  EXPECT_EQ(telemetryItems[21].value, 55);
+  EXPECT_EQ(telemetryItems[7].value, 77);
+
+  allowNewSensors = false;
+}
+
+static void generateSportPacket(uint8_t * packet, uint16_t id, uint32_t data)
+{
+  packet[0] = 0x22;
+  packet[1] = 0x10; // DATA_FRAME
+  *((uint16_t *)(packet+2)) = id;
+  *((uint32_t *)(packet+4)) = data;
+  setSportPacketCrc(packet);
+}
+
+TEST(FrSkySPORT, sensorsDescriptors)
+{
+  uint8_t packet[FRSKY_SPORT_PACKET_SIZE];
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  telemetryStreaming = TELEMETRY_TIMEOUT10ms;
+  telemetryData.telemetryValid = 0x07;
+  allowNewSensors = true;
+
+  // first, last and middle entries of the sorted descriptors table
+  const struct {
+    uint16_t id;
+    TelemetryUnit unit;
+    uint8_t prec;
+  } sensors[] = {
+    { ALT_FIRST_ID + 5, UNIT_METERS, 1 }, // distances are shown with 1 decimal at most
+    { FUEL_QTY_LAST_ID, UNIT_MILLILITERS, 2 },
+    { ESC_TEMPERATURE_FIRST_ID + 3, UNIT_CELSIUS, 0 },
+    { GASSUIT_AVG_FLOW_FIRST_ID, UNIT_MILLILITERS_PER_MINUTE, 0 },
+    { VALID_FRAME_RATE_ID, UNIT_PERCENT, 0 },
+    { 0x0F05, UNIT_RAW, 0 }, // unknown
+  };
+
+  for (unsigned i = 0; i < DIM(sensors); i++) {
+    generateSportPacket(packet, sensors[i].id, 10);
+    sportProcessTelemetryPacket(packet);
+    EXPECT_EQ(g_model.telemetrySensors[i].id, sensors[i].id);
+    EXPECT_EQ(g_model.telemetrySensors[i].unit, sensors[i].unit);
+    EXPECT_EQ(g_model.telemetrySensors[i].prec, sensors[i].prec);
+  }
+
+  allowNewSensors = false;
+}
@@ -61,9 +61,19 @@ inline void SYSTEM_RESET()
   }
 }
 
+// The mixer, the logical switches and the telemetry keep data decoded from
+// g_model until modelDataRevision changes: tests which write into g_model
+// must call this before evaluating it again, as the UI does through
+// storageDirty()
+inline void MODEL_CHANGED()
+{
+  storageDirty(EE_MODEL);
+}
+
 inline void MODEL_RESET()
 {
   memset(&g_model, 0, sizeof(g_model));
+  MODEL_CHANGED();
   memset(&anaInValues, 0, sizeof(anaInValues));
   extern uint8_t s_mixer_first_run_done;
   s_mixer_first_run_done = false;
@@ -91,6 +101,7 @@ inline void TELEMETRY_RESET()
     telemetryItems[i].clear();
   }
   memclear(g_model.telemetrySensors, sizeof(g_model.telemetrySensors));
+  MODEL_CHANGED();
 }
 
 class OpenTxTest : public testing::Test 
@@ -489,6 +489,52 @@ TEST(Curves, LinearIntpol)
   EXPECT_EQ(applyCustomCurve(-192, 0), -192);
 }
 
+static void checkCachedCurve(uint8_t idx)
+{
+  for (int x = -RESX; x <= RESX; x++) {
+    int exact = applyCustomCurve(x, idx);
+    ASSERT_LE(abs(applyCachedCurve(x, idx) - exact), 1) << "x=" << x;
+  }
+}
+
+TEST(Curves, CachedSmoothCurve)
+{
+  SYSTEM_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+  setModelDefaults();
+
+  CurveHeader & crv = g_model.curves[0];
+  crv.smooth = 1;
+
+  // 5 points standard curve
+  const int8_t std5[] = { -100, -20, 30, 90, 100 };
+  memcpy(g_model.points, std5, sizeof(std5));
+  MODEL_CHANGED();
+  checkCachedCurve(0);
+
+  // curve edited: cache must follow
+  g_model.points[2] = -60;
+  MODEL_CHANGED();
+  checkCachedCurve(0);
+
+  // 17 points standard curve with local extrema
+  crv.points = 12;
+  for (int i = 0; i < 17; i++) {
+    g_model.points[i] = (i & 1) ? 100 - 6 * i : -100 + 5 * i;
+  }
+  MODEL_CHANGED();
+  checkCachedCurve(0);
+
+  // 5 points custom curve with uneven x
+  crv.type = CURVE_TYPE_CUSTOM;
+  crv.points = 0;
+  const int8_t custom5[] = { -100, 80, -10, 40, 100, -90, -70, 60 };
+  memcpy(g_model.points, custom5, sizeof(custom5));
+  MODEL_CHANGED();
+  checkCachedCurve(0);
+}
+
 
 
 TEST_F(MixerTest, InfiniteRecursiveChannels)
@@ -561,6 +607,154 @@ TEST_F(MixerTest, RecursiveAddChannelAfterInactivePhase)
   EXPECT_EQ(chans[1], CHANNEL_MAX);
 }
 
+TEST_F(MixerTest, ChannelsChain)
+{
+  // CH1 <- CH2 <- CH3 <- MAX: the channels are computed CH3 first, and the
+  // whole chain is up to date after one run
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_CH2;
+  g_model.mixData[0].weight = 100;
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_CH3;
+  g_model.mixData[1].weight = 100;
+  g_model.mixData[2].destCh = 2;
+  g_model.mixData[2].srcRaw = MIXSRC_MAX;
+  g_model.mixData[2].weight = 50;
+  MODEL_CHANGED();
+  evalMixes(1);
+  EXPECT_EQ(chans[2], CHANNEL_MAX/2);
+  EXPECT_EQ(chans[1], CHANNEL_MAX/2);
+  EXPECT_EQ(chans[0], CHANNEL_MAX/2);
+  EXPECT_EQ(mixerLoopChannels, (bitfield_channels_t)0);
+}
+
+TEST_F(MixerTest, TwoChannelsLoop)
+{
+  // CH1 = 50% MAX + 50% CH2, CH2 = CH1: CH1 is computed first with the
+  // value of CH2 from the previous run, then CH2 with the new CH1. The loop
+  // makes one step per run.
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 50;
+  g_model.mixData[1].destCh = 0;
+  g_model.mixData[1].mltpx = MLTPX_ADD;
+  g_model.mixData[1].srcRaw = MIXSRC_CH2;
+  g_model.mixData[1].weight = 50;
+  g_model.mixData[2].destCh = 1;
+  g_model.mixData[2].srcRaw = MIXSRC_CH1;
+  g_model.mixData[2].weight = 100;
+  MODEL_CHANGED();
+
+  evalMixes(1);
+  EXPECT_EQ(mixerLoopChannels, (bitfield_channels_t)0x03);
+  EXPECT_EQ(chans[0], CHANNEL_MAX/2);
+  EXPECT_EQ(chans[1], CHANNEL_MAX/2);
+
+  evalMixes(1);
+  EXPECT_EQ(chans[0], CHANNEL_MAX*3/4);
+  EXPECT_EQ(chans[1], CHANNEL_MAX*3/4);
+
+  evalMixes(1);
+  EXPECT_EQ(chans[0], CHANNEL_MAX*7/8);
+  EXPECT_EQ(chans[1], CHANNEL_MAX*7/8);
+}
+
+TEST_F(MixerTest, MixPlanFollowsModelChanges)
+{
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  MODEL_CHANGED();
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX);
+
+  // the plan is kept while the model does not change
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX);
+
+  g_model.mixData[0].weight = 50;
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_CH1;
+  g_model.mixData[1].weight = -100;
+  MODEL_CHANGED();
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX/2);
+  EXPECT_EQ(chans[1], -CHANNEL_MAX/2);
+
+  // a deleted line is removed from the plan
+  memclear(&g_model.mixData[1], sizeof(MixData));
+  MODEL_CHANGED();
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[1], 0);
+}
+
+// the input editors preview: no source is overridden, the cache is not used
+#define CHECK_INPUTS_UNCACHED() \
+    do { \
+      int16_t expected[MAX_INPUTS] = {0}; \
+      applyExpos(expected, e_perout_mode_inactive_flight_mode, MIXSRC_NONE, 0); \
+      for (int i = 0; i < 4; i++) \
+        GTEST_ASSERT_EQ(expected[i], anas[i]); \
+    } while (0)
+
+TEST_F(MixerTest, InputsCacheFollowsSourcesAndGVars)
+{
+  for (int i = 0; i < 4; i++) {
+    ExpoData * expo = expoAddress(i);
+    expo->srcRaw = MIXSRC_Rud + i;
+    expo->chn = i;
+    expo->mode = 3;
+    expo->weight = 100;
+  }
+  expoAddress(0)->curve.type = CURVE_REF_EXPO;
+  expoAddress(0)->curve.value = 40;
+  expoAddress(1)->curve.type = CURVE_REF_DIFF;
+  expoAddress(1)->curve.value = 30;
+  expoAddress(1)->offset = 10;
+  expoAddress(3)->weight = 75;
+#if defined(GVARS)
+  expoAddress(2)->weight = -128;  // GV1
+  g_model.flightModeData[0].gvars[0] = 50;
+#endif
+  MODEL_CHANGED();
+
+  for (int i = 0; i < 4; i++)
+    anaInValues[i] = 100 * (i + 1);
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  CHECK_INPUTS_UNCACHED();
+
+  // only 2 sources move: the other lines are reused
+  anaInValues[1] = -300;
+  anaInValues[2] = 700;
+  expoCacheStats = {0, 0};
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(2u, expoCacheStats.hits);
+  EXPECT_EQ(2u, expoCacheStats.misses);
+  CHECK_INPUTS_UNCACHED();
+
+#if defined(GVARS)
+  // a GVAR change drops the cache, not the rest of the model data
+  uint32_t revision = modelDataRevision;
+  SET_GVAR(0, -20, 0);
+  EXPECT_EQ(revision, modelDataRevision);
+  expoCacheStats = {0, 0};
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(4u, expoCacheStats.misses);
+  CHECK_INPUTS_UNCACHED();
+#endif
+
+  // a preview with an overridden source, whichever its index, leaves the
+  // cache alone
+  int16_t preview[MAX_INPUTS];
+  expoCacheStats = {0, 0};
+  applyExpos(preview, e_perout_mode_inactive_flight_mode, 256, 0);
+  applyExpos(preview, e_perout_mode_inactive_flight_mode, MIXSRC_Rud, 512);
+  EXPECT_EQ(0u, expoCacheStats.hits + expoCacheStats.misses);
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(4u, expoCacheStats.hits);
+  CHECK_INPUTS_UNCACHED();
+}
+
 
 TEST_F(MixerTest, SlowOnPhase)
 {
@@ -30,6 +30,7 @@ void setLogicalSwitch(int index, uint16_t _func, int16_t _v1, int16_t _v2, int16
   g_model.logicalSw[index].delay = _delay;
   g_model.logicalSw[index].duration = _duration;
   g_model.logicalSw[index].andsw = _andsw;
+  MODEL_CHANGED();
 }
 
 #if defined(PCBTARANIS)
@@ -67,6 +68,81 @@ TEST(getSwitch, OldTypeStickyCSW)
 }
 #endif
 
+#if defined(PCBTARANIS)
+TEST(evalLogicalSwitches, chainedInSameTick)
+{
+  RADIO_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+
+  // L1 uses L2 which uses L3, in reverse order of the list
+  setLogicalSwitch(0, LS_FUNC_AND, SWSRC_SW2, SWSRC_SW2);
+  setLogicalSwitch(1, LS_FUNC_VPOS, MIXSRC_SW1+2, 0);
+  setLogicalSwitch(2, LS_FUNC_AND, SWSRC_SA0, SWSRC_SA0);
+
+  simuSetSwitch(0, 0);
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+
+  simuSetSwitch(0, -1);
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW1+2), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW2), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), true);
+
+  // L4 and L5 use each other: the loop reads the previous tick
+  setLogicalSwitch(3, LS_FUNC_OR, SWSRC_SW1+4, SWSRC_SA0);
+  setLogicalSwitch(4, LS_FUNC_AND, SWSRC_SW1+3, SWSRC_SW1+3);
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW1+3), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW1+4), true);
+
+  simuSetSwitch(0, 0);
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+  EXPECT_EQ(getSwitch(SWSRC_SW1+3), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW1+4), true);
+}
+#endif
+
+#if defined(PCBTARANIS)
+TEST(evalLogicalSwitches, contextsKeptOnModelChange)
+{
+  RADIO_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+
+  // L1 on 5 timer ticks after SA0, L2 on with SA0
+  setLogicalSwitch(0, LS_FUNC_AND, SWSRC_SA0, SWSRC_SA0, 0, 5);
+  setLogicalSwitch(1, LS_FUNC_AND, SWSRC_SA0, SWSRC_SA0);
+
+  simuSetSwitch(0, -1);
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+  EXPECT_EQ(getSwitch(SWSRC_SW2), true);
+
+  // another part of the model changes (e.g. a GVAR): the delay goes on
+  for (int i = 0; i < 5; i++) {
+    logicalSwitchesTimerTick();
+    MODEL_CHANGED();
+    evalLogicalSwitches();
+  }
+  EXPECT_EQ(getSwitch(SWSRC_SW1), true);
+
+  // L1 edited: its delay restarts
+  g_model.logicalSw[0].delay = 3;
+  MODEL_CHANGED();
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+
+  // L2 deleted: it goes off
+  g_model.logicalSw[1].func = LS_FUNC_NONE;
+  MODEL_CHANGED();
+  evalLogicalSwitches();
+  EXPECT_EQ(getSwitch(SWSRC_SW2), false);
+}
+#endif
+
 TEST(getSwitch, nullSW)
 {
   MODEL_RESET();
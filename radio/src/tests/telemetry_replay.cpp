@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+#include <vector>
+
+#include "gtests.h"
+#include "telemetry/telemetry_capture.h"
+
+#if defined(CROSSFIRE)
+#include "telemetry/crossfire.h"
+#endif
+
+// Captures are written in memory
+static std::vector<uint8_t> capture;
+static std::vector<uint32_t> captureWrites;
+
+static bool captureWrite(const uint8_t * data, uint32_t size)
+{
+  capture.insert(capture.end(), data, data + size);
+  captureWrites.push_back(size);
+  return true;
+}
+
+static void captureBytes(TelemetryCaptureWriter & writer, uint32_t time, uint8_t moduleType,
+                         uint8_t protocol, const uint8_t * data, uint32_t size)
+{
+  writer.startChunk(time, EXTERNAL_MODULE, moduleType, protocol);
+  for (uint32_t i = 0; i < size; i++) {
+    writer.write(data[i]);
+  }
+}
+
+static TelemetryItem * getTelemetryItem(uint16_t id)
+{
+  for (int i = 0; i < MAX_TELEMETRY_SENSORS; i++) {
+    if (g_model.telemetrySensors[i].isAvailable() && g_model.telemetrySensors[i].id == id)
+      return &telemetryItems[i];
+  }
+  return nullptr;
+}
+
+// Starts the module type a chunk was captured with, and returns the driver
+// telemetryWakeup() polls for it, nullptr for the legacy decoders
+static const etx_module_driver_t * getReplayDriver(uint8_t module, uint8_t moduleType, void *& context)
+{
+  g_model.moduleData[module].type = moduleType;
+  context = nullptr;
+
+#if defined(HARDWARE_INTERNAL_MODULE)
+  if (module == INTERNAL_MODULE) {
+    setupPulsesInternalModule();
+    context = getIntModuleCtx();
+    return getIntModuleDriver();
+  }
+#endif
+
+#if defined(HARDWARE_EXTERNAL_MODULE)
+  if (module == EXTERNAL_MODULE) {
+    setupPulsesExternalModule();
+    context = getExtModuleCtx();
+    return getExtModuleDriver();
+  }
+#endif
+
+  return nullptr;
+}
+
+// Feeds a capture to the telemetry parsers the way telemetryWakeup() does,
+// as fast as they can go. Returns the number of bytes replayed.
+static uint32_t replayCapture(const uint8_t * data, uint32_t size)
+{
+  TelemetryCaptureReader reader(data, size);
+  TelemetryCaptureChunk chunk;
+  uint32_t count = 0;
+
+  const etx_module_driver_t * drivers[NUM_MODULES] = {};
+  void * contexts[NUM_MODULES] = {};
+  uint8_t moduleTypes[NUM_MODULES];
+  memset(moduleTypes, 0xFF, sizeof(moduleTypes));
+
+  while (reader.next(chunk)) {
+    g_tmr10ms = chunk.time;
+    // the decoders are tested here, not the telemetry timeouts
+    telemetryStreaming = TELEMETRY_TIMEOUT10ms;
+    count += chunk.length;
+
+    uint8_t module = chunk.module;
+    if (module >= NUM_MODULES)
+      continue;
+
+    if (moduleTypes[module] != chunk.moduleType) {
+      moduleTypes[module] = chunk.moduleType;
+      drivers[module] = getReplayDriver(module, chunk.moduleType, contexts[module]);
+    }
+
+    const etx_module_driver_t * driver = drivers[module];
+    if (driver && driver->processData) {
+      uint8_t * rxBuffer = getTelemetryRxBuffer(module);
+      uint8_t & rxBufferCount = getTelemetryRxBufferCount(module);
+      for (uint8_t i = 0; i < chunk.length; i++) {
+        driver->processData(contexts[module], chunk.data[i], rxBuffer, &rxBufferCount);
+      }
+      continue;
+    }
+
+    // as pollExtTelemetryLegacy()
+    telemetryProtocol = chunk.protocol;
+    for (uint8_t i = 0; i < chunk.length; i++) {
+      processTelemetryData(chunk.data[i]);
+    }
+  }
+
+  EXPECT_FALSE(reader.isCorrupted());
+
+#if defined(HARDWARE_INTERNAL_MODULE)
+  stopPulsesInternalModule();
+#endif
+#if defined(HARDWARE_EXTERNAL_MODULE)
+  stopPulsesExternalModule();
+#endif
+
+  return count;
+}
+
+class TelemetryReplayTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+      capture.clear();
+      captureWrites.clear();
+      MODEL_RESET();
+      TELEMETRY_RESET();
+      // the previous replay may have left a partial frame
+      getTelemetryRxBufferCount(EXTERNAL_MODULE) = 0;
+      telemetryData.telemetryValid = 0x07;
+      allowNewSensors = true;
+    }
+};
+
+TEST_F(TelemetryReplayTest, captureFormat)
+{
+  TelemetryCaptureWriter writer;
+  std::vector<uint8_t> written;
+
+  // appended to a file which does not end on a sector boundary
+  capture.assign(100, 0xAA);
+  writer.start(capture.size(), captureWrite);
+  for (uint32_t i = 0; i < 3000; i++) {
+    if (i % 7 == 0) {
+      writer.startChunk(i / 100, EXTERNAL_MODULE, MODULE_TYPE_NONE, PROTOCOL_TELEMETRY_FRSKY_SPORT);
+    }
+    writer.write(i * 13);
+    written.push_back(i * 13);
+  }
+  EXPECT_TRUE(writer.close());
+
+  // whole sectors are written, except when closing
+  ASSERT_GE(captureWrites.size(), 2u);
+  EXPECT_EQ(412u, captureWrites[0]);
+  for (unsigned i = 1; i < captureWrites.size() - 1; i++) {
+    EXPECT_EQ(512u, captureWrites[i]);
+  }
+
+  // a second capture appended to the first one
+  uint32_t firstSize = capture.size();
+  writer.start(capture.size(), captureWrite);
+  writer.startChunk(1000, INTERNAL_MODULE, MODULE_TYPE_NONE, PROTOCOL_TELEMETRY_FRSKY_D);
+  for (uint32_t i = 0; i < 600; i++) {
+    writer.write(i);
+    written.push_back(i);
+  }
+  EXPECT_TRUE(writer.close());
+  EXPECT_EQ(512u - firstSize % 512, captureWrites[captureWrites.size() - 2]);
+
+  TelemetryCaptureReader reader(capture.data() + 100, capture.size() - 100);
+  TelemetryCaptureChunk chunk;
+  std::vector<uint8_t> read;
+  uint32_t lastTime = 0;
+  while (reader.next(chunk)) {
+    EXPECT_GE(chunk.time, lastTime);
+    EXPECT_GT(chunk.length, 0);
+    if (chunk.time == 1000) {
+      EXPECT_EQ(INTERNAL_MODULE, chunk.module);
+      EXPECT_EQ(PROTOCOL_TELEMETRY_FRSKY_D, chunk.protocol);
+    }
+    lastTime = chunk.time;
+    read.insert(read.end(), chunk.data, chunk.data + chunk.length);
+  }
+  EXPECT_FALSE(reader.isCorrupted());
+  EXPECT_EQ(written, read);
+
+  // a truncated capture is reported
+  TelemetryCaptureReader truncated(capture.data() + 100, capture.size() - 101);
+  while (truncated.next(chunk));
+  EXPECT_TRUE(truncated.isCorrupted());
+}
+
+TEST_F(TelemetryReplayTest, sport)
+{
+  TelemetryCaptureWriter writer;
+  writer.start(0, captureWrite);
+
+  // the FLVSS packets of FrSkySPORT.FrSkyDCells
+  const uint8_t packets[3][10] = {
+    { 0x7E, 0x98, 0x10, 0x06, 0x00, 0x07, 0xD0, 0x00, 0x00, 0x12 },
+    { 0x7E, 0x98, 0x10, 0x06, 0x00, 0x17, 0xD0, 0x00, 0x00, 0x02 },
+    { 0x7E, 0x98, 0x10, 0x06, 0x00, 0x27, 0xD0, 0x00, 0x00, 0xF1 },
+  };
+  for (int i = 0; i < 6; i++) {
+    captureBytes(writer, i, MODULE_TYPE_R9M_PXX1, PROTOCOL_TELEMETRY_FRSKY_SPORT, packets[i % 3], sizeof(packets[0]));
+  }
+  writer.close();
+
+  EXPECT_EQ(6 * sizeof(packets[0]), replayCapture(capture.data(), capture.size()));
+  EXPECT_EQ(telemetryItems[0].cells.count, 3);
+  EXPECT_EQ(telemetryItems[0].value, 1200);
+}
+
+#if defined(MULTIMODULE)
+TEST_F(TelemetryReplayTest, multi)
+{
+  TelemetryCaptureWriter writer;
+  writer.start(0, captureWrite);
+
+  // the FLVSS packets of the sport test, as forwarded by the module
+  const uint8_t packets[3][13] = {
+    { 'M', 'P', 0x02, 9, 0x98, 0x10, 0x06, 0x00, 0x07, 0xD0, 0x00, 0x00, 0x12 },
+    { 'M', 'P', 0x02, 9, 0x98, 0x10, 0x06, 0x00, 0x17, 0xD0, 0x00, 0x00, 0x02 },
+    { 'M', 'P', 0x02, 9, 0x98, 0x10, 0x06, 0x00, 0x27, 0xD0, 0x00, 0x00, 0xF1 },
+  };
+  for (int i = 0; i < 6; i++) {
+    captureBytes(writer, i, MODULE_TYPE_MULTIMODULE, PROTOCOL_TELEMETRY_MULTIMODULE, packets[i % 3], sizeof(packets[0]));
+  }
+  writer.close();
+
+  replayCapture(capture.data(), capture.size());
+  EXPECT_EQ(telemetryItems[0].cells.count, 3);
+  EXPECT_EQ(telemetryItems[0].value, 1200);
+}
+
+TEST_F(TelemetryReplayTest, hott)
+{
+  TelemetryCaptureWriter writer;
+  writer.start(0, captureWrite);
+
+  // HoTT receiver page, forwarded by the module: 5.2V, 25 degrees
+  const uint8_t packet[] = { 'M', 'P', 0x0E, 14,
+                             0x80, 100, 0x00, 0x00, 0x00, 52, 45, 0x80, 90, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  for (int i = 0; i < 3; i++) {
+    captureBytes(writer, i, MODULE_TYPE_MULTIMODULE, PROTOCOL_TELEMETRY_MULTIMODULE, packet, sizeof(packet));
+  }
+  writer.close();
+
+  replayCapture(capture.data(), capture.size());
+  TelemetryItem * voltage = getTelemetryItem(0x0003);  // HOTT_ID_RX_VLT
+  ASSERT_NE(nullptr, voltage);
+  EXPECT_EQ(52, voltage->value);
+  TelemetryItem * temperature = getTelemetryItem(0x0004);  // HOTT_ID_RX_TMP
+  ASSERT_NE(nullptr, temperature);
+  EXPECT_EQ(25, temperature->value);
+}
+#endif
+
+TEST_F(TelemetryReplayTest, spektrum)
+{
+  TelemetryCaptureWriter writer;
+  writer.start(0, captureWrite);
+
+  // Powerbox frames: 12.00V and 8.40V, 1000mAh and 500mAh used
+  uint8_t frame[18] = { 0xAA, 0x00, 0x0A, 0x00, 0x04, 0xB0, 0x03, 0x48, 0x03, 0xE8, 0x01, 0xF4 };
+  // the capture splits the frames anywhere
+  captureBytes(writer, 0, MODULE_TYPE_LEMON_DSMP, PROTOCOL_TELEMETRY_DSMP, frame, 7);
+  captureBytes(writer, 1, MODULE_TYPE_LEMON_DSMP, PROTOCOL_TELEMETRY_DSMP, frame + 7, sizeof(frame) - 7);
+  frame[5] = 0xA0;  // 11.84V
+  captureBytes(writer, 2, MODULE_TYPE_LEMON_DSMP, PROTOCOL_TELEMETRY_DSMP, frame, sizeof(frame));
+  writer.close();
+
+  replayCapture(capture.data(), capture.size());
+  TelemetryItem * battery1 = getTelemetryItem(0x0A00);
+  ASSERT_NE(nullptr, battery1);
+  EXPECT_EQ(1184, battery1->value);
+  EXPECT_EQ(1184, battery1->valueMin);
+  TelemetryItem * battery2 = getTelemetryItem(0x0A02);
+  ASSERT_NE(nullptr, battery2);
+  EXPECT_EQ(840, battery2->value);
+  TelemetryItem * consumption = getTelemetryItem(0x0A04);
+  ASSERT_NE(nullptr, consumption);
+  EXPECT_EQ(1000, consumption->value);
+}
+
+#if defined(CROSSFIRE)
+static uint8_t createCrossfireVarioFrame(uint8_t * frame, int16_t speed)
+{
+  frame[0] = RADIO_ADDRESS;
+  frame[1] = 4;
+  frame[2] = CF_VARIO_ID;
+  frame[3] = speed >> 8;
+  frame[4] = speed;
+  frame[5] = crc8(&frame[2], 3);
+  return 6;
+}
+
+TEST_F(TelemetryReplayTest, crossfire)
+{
+  TelemetryCaptureWriter writer;
+  writer.start(0, captureWrite);
+
+  uint8_t frame[CROSSFIRE_FRAME_MAXLEN];
+  // line noise, not starting any frame (no module or radio address)
+  const uint8_t noise[] = { 0x00, 0x30, 0x55 };
+  for (int i = 0; i < 100; i++) {
+    uint8_t length = createCrossfireVarioFrame(frame, i * 10 - 500);
+    if (i % 10 == 5) {
+      // a few frames are corrupted
+      frame[3] ^= 0x40;
+      captureBytes(writer, i, MODULE_TYPE_CROSSFIRE, PROTOCOL_TELEMETRY_CROSSFIRE, noise, sizeof(noise));
+    }
+    captureBytes(writer, i, MODULE_TYPE_CROSSFIRE, PROTOCOL_TELEMETRY_CROSSFIRE, frame, length);
+  }
+  writer.close();
+
+  replayCapture(capture.data(), capture.size());
+  EXPECT_EQ(CF_VARIO_ID, g_model.telemetrySensors[0].id);
+  // the vertical speed is in cm/s, shown with one decimal in m/s
+  EXPECT_EQ((99 * 10 - 500) / 10, telemetryItems[0].value);
+  EXPECT_EQ(-500 / 10, telemetryItems[0].valueMin);
+}
+#endif
+
+// Not a pass / fail test, it measures how fast the parsers go through real
+// traffic, and is only run on demand (--gtest_also_run_disabled_tests). A
+// capture taken on a radio is replayed when TELEMETRY_CAPTURE gives its path,
+// a synthetic one otherwise. The throughput is recorded as a test property.
+TEST_F(TelemetryReplayTest, DISABLED_benchmark)
+{
+  typedef std::chrono::steady_clock clock;
+
+  const char * path = getenv("TELEMETRY_CAPTURE");
+  if (path) {
+    FILE * file = fopen(path, "rb");
+    ASSERT_NE(nullptr, file) << path;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      capture.insert(capture.end(), buffer, buffer + count);
+    }
+    fclose(file);
+  }
+  else {
+    TelemetryCaptureWriter writer;
+    writer.start(0, captureWrite);
+    const uint8_t sport[] = { 0x7E, 0x98, 0x10, 0x06, 0x00, 0x07, 0xD0, 0x00, 0x00, 0x12 };
+    for (int i = 0; i < 50000; i++) {
+#if defined(CROSSFIRE)
+      uint8_t frame[CROSSFIRE_FRAME_MAXLEN];
+      uint8_t length = createCrossfireVarioFrame(frame, i % 1000);
+      captureBytes(writer, i, MODULE_TYPE_CROSSFIRE, PROTOCOL_TELEMETRY_CROSSFIRE, frame, length);
+#endif
+      captureBytes(writer, i, MODULE_TYPE_R9M_PXX1, PROTOCOL_TELEMETRY_FRSKY_SPORT, sport, sizeof(sport));
+    }
+    writer.close();
+  }
+
+  TelemetryCaptureReader reader(capture.data(), capture.size());
+  TelemetryCaptureChunk chunk;
+  uint32_t first = 0, last = 0;
+  if (reader.next(chunk)) {
+    first = last = chunk.time;
+    while (reader.next(chunk)) {
+      last = chunk.time;
+    }
+  }
+
+  auto start = clock::now();
+  uint32_t count = replayCapture(capture.data(), capture.size());
+  double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+  RecordProperty("bytes", count);
+  RecordProperty("trafficMs", (last - first) * 10);
+  RecordProperty("replayUs", (int)(elapsed * 1000000));
+}
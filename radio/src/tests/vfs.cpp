@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+#include "VirtualFS.h"
+#include "location.h"
+
+#include <vector>
+
+// Stands for the file system under a VfsWriteBuffer
+struct WriteSink {
+  std::string data;
+  std::vector<size_t> writes;
+  size_t space = SIZE_MAX;
+
+  static VfsError write(void* ctx, const void* buf, size_t size, size_t& written)
+  {
+    auto sink = static_cast<WriteSink*>(ctx);
+    written = std::min(size, sink->space);
+    sink->space -= written;
+    sink->data.append(static_cast<const char*>(buf), written);
+    sink->writes.push_back(written);
+    return VfsError::OK;
+  }
+};
+
+TEST(Vfs, writeBufferAlignedBlocks)
+{
+  VfsWriteBuffer buffer;
+  WriteSink sink;
+  std::string expected;
+  size_t written;
+
+  // the file already holds 100 bytes: the first block is partial
+  size_t position = 100;
+  for (int i = 0; i < 200; i++) {
+    std::string line = std::to_string(i) + ",";
+    EXPECT_EQ(VfsError::OK, buffer.write(line.data(), line.size(), position, written, WriteSink::write, &sink));
+    EXPECT_EQ(line.size(), written);
+    expected += line;
+    position += written;
+    // what is not written yet is pending (VfsFile::tell() counts it)
+    EXPECT_EQ(expected.size(), sink.data.size() + buffer.pending());
+  }
+  ASSERT_GE(sink.writes.size(), 1u);
+  EXPECT_EQ(VFS_WRITE_BUFFER_SIZE - 100, sink.writes[0]);
+  for (unsigned i = 1; i < sink.writes.size(); i++) {
+    EXPECT_EQ(VFS_WRITE_BUFFER_SIZE, sink.writes[i]);
+  }
+
+  // whole blocks bypass the buffer once it is empty
+  std::string block(3 * VFS_WRITE_BUFFER_SIZE + 17, 'x');
+  size_t pending = buffer.pending();
+  EXPECT_EQ(VfsError::OK, buffer.write(block.data(), block.size(), position, written, WriteSink::write, &sink));
+  EXPECT_EQ(block.size(), written);
+  expected += block;
+  position += written;
+  size_t n = sink.writes.size();
+  ASSERT_GE(n, 2u);
+  EXPECT_EQ(VFS_WRITE_BUFFER_SIZE, sink.writes[n - 2]);
+  EXPECT_EQ(2 * VFS_WRITE_BUFFER_SIZE, sink.writes[n - 1]);
+  EXPECT_EQ(pending + block.size() - 3 * VFS_WRITE_BUFFER_SIZE, buffer.pending());
+  EXPECT_EQ(0u, (100 + sink.data.size()) % VFS_WRITE_BUFFER_SIZE);
+
+  // flush() writes what remains
+  EXPECT_EQ(VfsError::OK, buffer.flush(WriteSink::write, &sink));
+  EXPECT_EQ(0u, buffer.pending());
+  EXPECT_EQ(expected, sink.data);
+  EXPECT_EQ(VfsError::OK, buffer.flush(WriteSink::write, &sink));
+  EXPECT_EQ(expected, sink.data);
+  buffer.release();
+}
+
+TEST(Vfs, writeBufferErrors)
+{
+  VfsWriteBuffer buffer;
+  WriteSink sink;
+  sink.space = 10;
+  size_t written;
+
+  // the buffered bytes are accepted, the error comes with the flush
+  EXPECT_EQ(VfsError::OK, buffer.write("0123456789ABCDEF", 16, 0, written, WriteSink::write, &sink));
+  EXPECT_EQ(16u, written);
+  EXPECT_EQ(VfsError::NOSPC, buffer.flush(WriteSink::write, &sink));
+  EXPECT_EQ(0u, buffer.pending());
+  EXPECT_EQ("0123456789", sink.data);
+
+  // direct writes report what was written
+  std::string block(VFS_WRITE_BUFFER_SIZE, 'x');
+  EXPECT_EQ(VfsError::OK, buffer.write(block.data(), block.size(), 0, written, WriteSink::write, &sink));
+  EXPECT_EQ(0u, written);
+  buffer.release();
+}
+
+#if defined(USE_FATFS)
+
+static std::string readFile(const char * path)
+{
+  std::string result;
+  VfsFile file;
+  if (VirtualFS::instance().openFile(file, path, VfsOpenFlags::READ) != VfsError::OK)
+    return result;
+
+  char buffer[100];
+  size_t count;
+  while (file.read(buffer, sizeof(buffer), count) == VfsError::OK && count > 0)
+    result.append(buffer, count);
+  file.close();
+  return result;
+}
+
+TEST(Vfs, write)
+{
+  simuFatfsSetPaths(TESTS_BUILD_PATH "/", TESTS_BUILD_PATH "/");
+
+  VfsFile file;
+  ASSERT_EQ(VfsError::OK, VirtualFS::instance().openFile(file, ROOT_PATH "vfs_test.txt", VfsOpenFlags::CREATE_ALWAYS | VfsOpenFlags::WRITE));
+
+  std::string expected;
+  size_t written;
+  for (int i = 0; i < 300; i++) {
+    std::string line = std::to_string(i) + ",";
+    EXPECT_EQ(VfsError::OK, file.write(line.data(), line.size(), written));
+    EXPECT_EQ(line.size(), written);
+    expected += line;
+    EXPECT_EQ(expected.size(), file.tell());
+  }
+
+  // larger than VFS_WRITE_BUFFER_SIZE
+  std::string block(3 * VFS_WRITE_BUFFER_SIZE + 17, 'x');
+  EXPECT_EQ(VfsError::OK, file.write(block.data(), block.size(), written));
+  EXPECT_EQ(block.size(), written);
+  expected += block;
+
+  EXPECT_EQ(VfsError::OK, file.puts("\n"));
+  EXPECT_EQ(VfsError::OK, file.putc('!'));
+  expected += "\n!";
+  EXPECT_EQ((int)expected.size(), file.size());
+
+  EXPECT_EQ(VfsError::OK, file.close());
+  EXPECT_EQ(expected, readFile(ROOT_PATH "vfs_test.txt"));
+
+  VirtualFS::instance().unlink(ROOT_PATH "vfs_test.txt");
+  simuFatfsSetPaths("", "");
+}
+
+TEST(Vfs, fprintf)
+{
+  simuFatfsSetPaths(TESTS_BUILD_PATH "/", TESTS_BUILD_PATH "/");
+
+  VfsFile file;
+  ASSERT_EQ(VfsError::OK, VirtualFS::instance().openFile(file, ROOT_PATH "vfs_test.txt", VfsOpenFlags::CREATE_ALWAYS | VfsOpenFlags::WRITE));
+  EXPECT_EQ(6, file.fprintf("%d,%u,", -12, 7u));
+  EXPECT_EQ(14, file.fprintf("%02d:%4d:%06d", 5, 42, -31));
+  EXPECT_EQ(15, file.fprintf("%-11s|%s|", "abc", "de"));
+  EXPECT_EQ(16, file.fprintf("%02X %08X 100%%", 0xA, 0xBEEF));
+  EXPECT_EQ(VfsError::OK, file.close());
+
+  EXPECT_EQ("-12,7,05:  42:-00031abc        |de|0A 0000BEEF 100%", readFile(ROOT_PATH "vfs_test.txt"));
+
+  // errors are reported as by f_printf()
+  EXPECT_EQ(EOF, file.fprintf("%d", 1));
+
+  VirtualFS::instance().unlink(ROOT_PATH "vfs_test.txt");
+  simuFatfsSetPaths("", "");
+}
+
+#endif
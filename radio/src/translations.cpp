@@ -230,6 +230,7 @@ const char STR_HZ[]  = TR_HZ;
 const char STR_TMIXMAXMS[] = TR_TMIXMAXMS;
 const char STR_FREE_STACK[] = TR_FREE_STACK;
 const char STR_INT_GPS_LABEL[]  = TR_INT_GPS_LABEL;
+const char STR_DISK_CACHE_LABEL[] = TR_DISK_CACHE_LABEL;
 const char STR_HEARTBEAT_LABEL[]  = TR_HEARTBEAT_LABEL;
 const char STR_LUA_SCRIPTS_LABEL[]  = TR_LUA_SCRIPTS_LABEL;
 const char STR_FREE_MEM_LABEL[]  = TR_FREE_MEM_LABEL;
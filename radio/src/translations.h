@@ -394,6 +394,7 @@ extern const char STR_HZ[];
 extern const char STR_TMIXMAXMS[];
 extern const char STR_FREE_STACK[];
 extern const char STR_INT_GPS_LABEL[];
+extern const char STR_DISK_CACHE_LABEL[];
 extern const char STR_HEARTBEAT_LABEL[];
 extern const char STR_LUA_SCRIPTS_LABEL[];
 extern const char STR_FREE_MEM_LABEL[];
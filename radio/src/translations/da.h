@@ -488,6 +488,7 @@
 #define TR_TMIXMAXMS                   "Tmix max"
 #define TR_FREE_STACK                  "Fri stak"
 #define TR_INT_GPS_LABEL               "Intern GPS"
+#define TR_DISK_CACHE_LABEL            "SD kort cache"
 #define TR_HEARTBEAT_LABEL             "Hjerte puls"
 #define TR_LUA_SCRIPTS_LABEL           "Lua script"
 #define TR_FREE_MEM_LABEL              "Fri mem"
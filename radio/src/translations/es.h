@@ -490,6 +490,7 @@
 #define TR_TMIXMAXMS                  "Tmix máx"
 #define TR_FREE_STACK                 "Stack libre"
 #define TR_INT_GPS_LABEL               "Internal GPS"
+#define TR_DISK_CACHE_LABEL            "Caché SD"
 #define TR_HEARTBEAT_LABEL             "Heartbeat"
 #define TR_LUA_SCRIPTS_LABEL          "Lua scripts"
 #define TR_FREE_MEM_LABEL             "Free mem"
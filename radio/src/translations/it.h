@@ -499,6 +499,7 @@
 #define TR_TMIXMAXMS                  "Tmix max"
 #define TR_FREE_STACK                 "Stack libero"
 #define TR_INT_GPS_LABEL               "GPS interno"
+#define TR_DISK_CACHE_LABEL            "Cache SD"
 #define TR_HEARTBEAT_LABEL             "Heartbeat"
 #define TR_LUA_SCRIPTS_LABEL          "Lua scripts"
 #define TR_FREE_MEM_LABEL             "Mem. libera"
@@ -500,6 +500,7 @@
 #define TR_TMIXMAXMS                   "Tmix最大値"
 #define TR_FREE_STACK                  "Free stack"
 #define TR_INT_GPS_LABEL               "内蔵GPS"
+#define TR_DISK_CACHE_LABEL            "SDキャッシュ"
 #define TR_HEARTBEAT_LABEL             "ハートビート"
 #define TR_LUA_SCRIPTS_LABEL           "LUAスクリプト"
 #define TR_FREE_MEM_LABEL              "空きメモリ"
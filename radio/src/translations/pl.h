@@ -495,6 +495,7 @@
 #define TR_TMIXMAXMS                  "TmixMaks"
 #define TR_FREE_STACK                 "Wolny stos"
 #define TR_INT_GPS_LABEL               "Internal GPS"
+#define TR_DISK_CACHE_LABEL            "Bufor SD"
 #define TR_HEARTBEAT_LABEL             "Heartbeat"
 #define TR_LUA_SCRIPTS_LABEL          "Lua scripts"
 #define TR_FREE_MEM_LABEL             "Free mem"
@@ -493,6 +493,7 @@
 #define TR_TMIXMAXMS                  "Tmix max"
 #define TR_FREE_STACK                 "Free stack"
 #define TR_INT_GPS_LABEL               "Internal GPS"
+#define TR_DISK_CACHE_LABEL            "Cache SD"
 #define TR_HEARTBEAT_LABEL             "Heartbeat"
 #define TR_LUA_SCRIPTS_LABEL          "Lua scripts"
 #define TR_FREE_MEM_LABEL             "Free mem"
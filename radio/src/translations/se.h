@@ -531,6 +531,7 @@
 #define TR_TMIXMAXMS                    "Tmix max"
 #define TR_FREE_STACK                   "Fri stack"
 #define TR_INT_GPS_LABEL                "Intern GPS"
+#define TR_DISK_CACHE_LABEL             "SD-cache"
 #define TR_HEARTBEAT_LABEL              "Heartbeat"
 #define TR_LUA_SCRIPTS_LABEL            "Lua-skript"
 #define TR_FREE_MEM_LABEL               "Free mem"
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+    Converts binary logs (LOG_BINARY firmware option, .etl files) to the CSV
+    layout written by the radio.
+
+    Usage:
+
+        ./log2csv.py model-2024-01-01-120000.etl [output.csv]
+"""
+
+import struct
+import sys
+import time
+
+MAGIC = b"ETXL"
+VERSION = 1
+FLAG_RTC = 0x01
+RECORD = ord("R")
+
+COLUMN_VALUE = 0
+COLUMN_GPS = 1
+COLUMN_DATETIME = 2
+COLUMN_TEXT = 3
+
+TEXT_LENGTH = 16
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def read(self, size):
+        if self.pos + size > len(self.data):
+            raise EOFError()
+        result = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return result
+
+    def unpack(self, fmt):
+        return struct.unpack("<" + fmt, self.read(struct.calcsize("<" + fmt)))
+
+    def u8(self):
+        return self.unpack("B")[0]
+
+
+def format_prec(value, prec):
+    if prec == 0:
+        return "%d" % value
+    sign = "-" if value < 0 else ""
+    quot, rem = divmod(abs(value), 10 ** prec)
+    return "%s%d.%0*d" % (sign, quot, prec, rem)
+
+
+def format_gps(value):
+    sign = "-" if value < 0 else ""
+    quot, rem = divmod(abs(value), 1000000)
+    return "%s%d.%06d" % (sign, quot, rem)
+
+
+class Session:
+    def __init__(self, reader):
+        version, flags = reader.unpack("BB")
+        if version != VERSION:
+            raise ValueError("unsupported log version %d" % version)
+        self.rtc = flags & FLAG_RTC
+        end = reader.data.index(b"\n", reader.pos)
+        self.header = reader.read(end + 1 - reader.pos).decode("utf-8", "replace")
+        self.columns = [reader.unpack("BB") for _ in range(reader.u8())]
+        self.analogs = reader.u8()
+        self.switches = reader.u8()
+        self.logical_switches = reader.u8()
+        self.channels = reader.u8()
+
+    def record(self, reader):
+        fields = []
+        seconds, ms100 = reader.unpack("IB")
+        if self.rtc:
+            tm = time.gmtime(seconds)
+            fields.append("%4d-%02d-%02d" % (tm.tm_year, tm.tm_mon, tm.tm_mday))
+            fields.append("%02d:%02d:%02d.%02d0" % (tm.tm_hour, tm.tm_min, tm.tm_sec, ms100))
+        else:
+            fields.append("%d" % seconds)
+
+        for kind, prec in self.columns:
+            if kind == COLUMN_GPS:
+                latitude, longitude = reader.unpack("ii")
+                if latitude and longitude:
+                    fields.append("%s %s" % (format_gps(latitude), format_gps(longitude)))
+                else:
+                    fields.append("")
+            elif kind == COLUMN_DATETIME:
+                fields.append("%4d-%02d-%02d %02d:%02d:%02d" % reader.unpack("HBBBBB"))
+            elif kind == COLUMN_TEXT:
+                text = reader.read(TEXT_LENGTH).split(b"\0")[0]
+                fields.append('"%s"' % text.decode("utf-8", "replace"))
+            else:
+                fields.append(format_prec(reader.unpack("i")[0], prec))
+
+        fields += ["%d" % v for v in reader.unpack("%dh" % self.analogs)]
+        fields += ["%d" % v for v in reader.unpack("%db" % self.switches)]
+        if self.logical_switches:
+            fields.append("0x%08X%08X" % reader.unpack("II"))
+        fields += ["%d" % v for v in reader.unpack("%dh" % self.channels)]
+        fields.append(format_prec(reader.unpack("H")[0], 1))
+        return ",".join(fields) + "\n"
+
+
+def convert(data, out):
+    reader = Reader(data)
+    session = None
+    try:
+        while not reader.eof():
+            tag = reader.read(1)
+            if tag == MAGIC[:1] and reader.read(len(MAGIC) - 1) == MAGIC[1:]:
+                previous = session
+                session = Session(reader)
+                if not previous or previous.header != session.header:
+                    out.write(session.header)
+            elif session and tag[0] == RECORD:
+                out.write(session.record(reader))
+            else:
+                raise ValueError("corrupted log at offset %d" % (reader.pos - 1))
+    except EOFError:
+        sys.stderr.write("truncated record at end of log\n")
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], "w", newline="") as out:
+            convert(data, out)
+    else:
+        convert(data, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()